@@ -0,0 +1,1146 @@
+// Micro-benchmarks for the chunk storage used by chunk_preview.
+//
+// Build the `chunk_bench` target in Release and run it without arguments.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <numeric>
+#include <thread>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+#include "../src/Chunk.h"
+#include "../src/PalettedChunk.h"
+#include "../src/ChunkLod.h"
+#include "../src/ChunkMesher.h"
+#include "../src/ChunkMeshScheduler.h"
+#include "../src/ChunkStore.h"
+#include "../src/ChunkStreamer.h"
+#include "../src/Frustum.h"
+#include "../src/ChunkOccluders.h"
+#include "../src/ChunkVisibility.h"
+#include "../src/EntityRegistry.h"
+#include "../src/LightEngine.h"
+#include "../src/MeshComponent.h"
+#include "../src/MeshOptimizer.h"
+#include "../src/Noise.h"
+#include "../src/OcclusionCuller.h"
+#include "../src/SparseVoxelOctree.h"
+#include "../src/TerrainGenerator.h"
+#include "../src/VoxelRaycast.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Keeps the optimizer from discarding benchmarked work.
+volatile std::uint64_t g_sink = 0;
+
+template<typename Fn>
+double time_ns(Fn&& fn, const int repetitions) {
+    // Warm up caches and branch predictors
+    fn();
+    const auto start = Clock::now();
+    for (int i = 0; i < repetitions; i++) {
+        fn();
+    }
+    const auto elapsed = Clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / repetitions;
+}
+
+void report(const std::string& name, const double ns_per_run, const size_t ops_per_run) {
+    std::cout << std::left << std::setw(44) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << ns_per_run / 1000.0 << " us/run"
+              << std::setw(10) << std::setprecision(2) << ns_per_run / static_cast<double>(ops_per_run) << " ns/op"
+              << std::endl;
+}
+
+// Rolling-hills terrain with `cave_percent` of solid blocks punched out, enough to
+// give meshing realistic branches.
+template<typename ChunkT>
+void fill_terrain(ChunkT& chunk, const int cave_percent = 5) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> noise(0, 99);
+    for (int z = 0; z < ChunkT::kSize; z++) {
+        for (int x = 0; x < ChunkT::kSize; x++) {
+            const int height = ChunkT::kSize / 2
+                + static_cast<int>(6.0f * std::sin(static_cast<float>(x) * 0.2f) * std::cos(static_cast<float>(z) * 0.15f));
+            for (int y = 0; y < ChunkT::kSize; y++) {
+                BlockId block = y < height ? (y < height - 3 ? 1 : 2) : kAir;
+                if (block != kAir && noise(rng) < cave_percent) {
+                    block = kAir; // caves
+                }
+                chunk.set(x, y, z, block);
+            }
+        }
+    }
+}
+
+template<typename ChunkT>
+void bench_layout(const std::string& label) {
+    auto chunk = std::make_unique<ChunkT>();
+    fill_terrain(*chunk);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> coordinate(0, ChunkT::kSize - 1);
+    std::vector<glm::ivec3> points(1 << 16);
+    for (auto& p : points) {
+        p = {coordinate(rng), coordinate(rng), coordinate(rng)};
+    }
+
+    report(label + " random get", time_ns([&] {
+        std::uint64_t sum = 0;
+        for (const auto& p : points) {
+            sum += chunk->get(p);
+        }
+        g_sink = g_sink + sum;
+    }, 50), points.size());
+
+    // Face visibility scan: the access pattern of a culling mesher
+    report(label + " neighbour scan", time_ns([&] {
+        std::uint64_t faces = 0;
+        for (int y = 1; y < ChunkT::kSize - 1; y++) {
+            for (int z = 1; z < ChunkT::kSize - 1; z++) {
+                for (int x = 1; x < ChunkT::kSize - 1; x++) {
+                    if (chunk->get(x, y, z) == kAir) {
+                        continue;
+                    }
+                    faces += chunk->get(x - 1, y, z) == kAir;
+                    faces += chunk->get(x + 1, y, z) == kAir;
+                    faces += chunk->get(x, y - 1, z) == kAir;
+                    faces += chunk->get(x, y + 1, z) == kAir;
+                    faces += chunk->get(x, y, z - 1) == kAir;
+                    faces += chunk->get(x, y, z + 1) == kAir;
+                }
+            }
+        }
+        g_sink = g_sink + faces;
+    }, 50), ChunkT::kVolume);
+
+    report(label + " for_each", time_ns([&] {
+        std::uint64_t sum = 0;
+        chunk->for_each([&](int, int, int, const BlockId block) { sum += block; });
+        g_sink = g_sink + sum;
+    }, 50), ChunkT::kVolume);
+
+    std::cout << std::left << std::setw(44) << (label + " storage")
+              << std::right << std::setw(12) << sizeof(ChunkT) / 1024 << " KiB" << std::endl;
+}
+
+template<typename ChunkT>
+size_t chunk_memory(const ChunkT& chunk) {
+    if constexpr (requires { chunk.memory_usage(); }) {
+        return chunk.memory_usage();
+    } else {
+        return sizeof(ChunkT);
+    }
+}
+
+// Get/set cost and memory of a storage type on a terrain chunk.
+template<typename ChunkT>
+void bench_storage(const std::string& label) {
+    auto chunk = std::make_unique<ChunkT>();
+    fill_terrain(*chunk);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coordinate(0, ChunkT::kSize - 1);
+    std::vector<glm::ivec3> points(1 << 16);
+    for (auto& p : points) {
+        p = {coordinate(rng), coordinate(rng), coordinate(rng)};
+    }
+
+    report(label + " random get", time_ns([&] {
+        std::uint64_t sum = 0;
+        for (const auto& p : points) {
+            sum += chunk->get(p);
+        }
+        g_sink = g_sink + sum;
+    }, 50), points.size());
+
+    // Overwrite with values already in the palette, the common edit case
+    report(label + " random set", time_ns([&] {
+        for (const auto& p : points) {
+            chunk->set(p, static_cast<BlockId>((p.x + p.y) % 3));
+        }
+    }, 50), points.size());
+
+    std::cout << std::left << std::setw(44) << (label + " memory")
+              << std::right << std::setw(12) << chunk_memory(*chunk) << " bytes" << std::endl;
+}
+
+// Visible faces before merging, i.e. what a per-block mesher would emit.
+template<typename ChunkT>
+size_t count_visible_faces(const ChunkT& chunk) {
+    size_t faces = 0;
+    chunk.for_each([&](const int x, const int y, const int z, const BlockId block) {
+        for (const auto& normal : kFaceNormals) {
+            faces += meshing::face_visible(block, meshing::sample(chunk, glm::ivec3(x, y, z) + normal)) ? 1 : 0;
+        }
+    });
+    return faces;
+}
+
+template<typename ChunkT>
+void bench_mesher(const std::string& label, const int cave_percent) {
+    auto chunk = std::make_unique<ChunkT>();
+    fill_terrain(*chunk, cave_percent);
+
+    const size_t faces = count_visible_faces(*chunk);
+    for (size_t i = 0; i < meshing::kMesherBackendNames.size(); i++) {
+        const auto backend = static_cast<meshing::MesherBackend>(i);
+        const std::string name = label + " " + meshing::kMesherBackendNames[i];
+
+        ChunkMeshBuilder builder;
+        report(name + " mesh", time_ns([&] {
+            builder.clear();
+            meshing::mesh_chunk(*chunk, backend, builder);
+        }, 50), ChunkT::kVolume);
+
+        std::cout << std::left << std::setw(44) << (name + " quads (culled / merged)")
+                  << std::right << std::setw(12) << faces << " / " << builder.quad_count()
+                  << " (" << std::setprecision(1) << static_cast<double>(faces) / builder.quad_count() << "x)" << std::endl;
+    }
+}
+
+// Meshes `count` chunks through the scheduler the way the render loop does: one
+// dispatch and a bounded number of polls per "frame". Reports total throughput
+// against meshing serially, and the worst time the render thread spent per frame.
+void bench_scheduler(const int count) {
+    auto terrain = std::make_shared<DenseChunk>();
+    fill_terrain(*terrain, 5);
+    const ChunkMeshScheduler::ChunkSnapshot snapshot = terrain;
+
+    const auto serial_start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        g_sink = g_sink + meshing::mesh_chunk(*snapshot, meshing::MesherBackend::Greedy)->indices.size();
+    }
+    const double serial_ms = std::chrono::duration<double, std::milli>(Clock::now() - serial_start).count();
+
+    JobSystem jobs;
+    ChunkMeshScheduler scheduler(jobs);
+    const auto start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        scheduler.request({i % 16, 0, i / 16}, snapshot);
+    }
+    int received = 0;
+    double worst_frame_us = 0.0;
+    while (received < count) {
+        const auto frame_start = Clock::now();
+        scheduler.dispatch(glm::vec3(0.0f));
+        for (int polls = 0; polls < 16; polls++) {
+            auto result = scheduler.poll();
+            if (!result) {
+                break;
+            }
+            g_sink = g_sink + result->mesh->indices.size();
+            received++;
+        }
+        worst_frame_us = std::max(worst_frame_us,
+                                  std::chrono::duration<double, std::micro>(Clock::now() - frame_start).count());
+        std::this_thread::yield();
+    }
+    const double parallel_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << std::left << std::setw(44) << ("serial, " + std::to_string(count) + " chunks")
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << serial_ms << " ms" << std::endl;
+    std::cout << std::left << std::setw(44) << ("jobs (" + std::to_string(jobs.worker_count()) + " workers)")
+              << std::right << std::setw(12) << parallel_ms << " ms" << std::endl;
+    std::cout << std::left << std::setw(44) << "worst render-thread frame"
+              << std::right << std::setw(12) << worst_frame_us << " us" << std::endl;
+}
+
+// Fills one whole region, then measures reopening it and loading every chunk back.
+void bench_region() {
+    const auto directory = std::filesystem::temp_directory_path() / "chunk_bench_world";
+    std::filesystem::remove_all(directory);
+
+    DenseChunk terrain;
+    fill_terrain(terrain, 5);
+    constexpr int size = RegionFile::kSize;
+
+    const auto write_start = Clock::now();
+    {
+        ChunkStore store(directory);
+        for (int y = 0; y < size; y++) {
+            for (int z = 0; z < size; z++) {
+                for (int x = 0; x < size; x++) {
+                    store.save({x, y, z}, terrain);
+                }
+            }
+        }
+    }
+    const double write_ms = std::chrono::duration<double, std::milli>(Clock::now() - write_start).count();
+
+    const auto open_start = Clock::now();
+    ChunkStore store(directory);
+    g_sink = g_sink + store.load({0, 0, 0})->data()[0];
+    const double open_us = std::chrono::duration<double, std::micro>(Clock::now() - open_start).count();
+
+    const double load_ns = time_ns([&] {
+        for (int y = 0; y < size; y++) {
+            for (int z = 0; z < size; z++) {
+                for (int x = 0; x < size; x++) {
+                    g_sink = g_sink + store.load({x, y, z})->data()[x];
+                }
+            }
+        }
+    }, 3);
+
+    const size_t file_size = std::filesystem::file_size(directory / "r.0.0.0.region");
+    std::cout << std::left << std::setw(44) << ("write " + std::to_string(RegionFile::kChunkCount) + " chunks")
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << write_ms << " ms" << std::endl;
+    std::cout << std::left << std::setw(44) << "region file size"
+              << std::right << std::setw(12) << static_cast<double>(file_size) / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << std::left << std::setw(44) << "open and load first chunk"
+              << std::right << std::setw(12) << open_us << " us" << std::endl;
+    report("load chunk", load_ns / RegionFile::kChunkCount, kChunkSize * kChunkSize * kChunkSize);
+
+    std::filesystem::remove_all(directory);
+}
+
+// Culls `count` boxes scattered around a camera with a 45 degree field of view,
+// comparing the batched SoA test against testing each box on its own.
+void bench_culling(const int count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(1.0f, 8.0f);
+
+    std::vector<Aabb> boxes;
+    FrustumCuller culler;
+    for (int i = 0; i < count; i++) {
+        const glm::vec3 center(position(rng), position(rng), position(rng));
+        const glm::vec3 half(size(rng));
+        boxes.push_back({center - half, center + half});
+        culler.add(boxes.back());
+    }
+
+    const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.5f, 0.1f, 1000.0f);
+    const Frustum frustum = Frustum::from(projection);
+
+    std::vector<std::uint8_t> visible;
+    size_t visible_count = 0;
+    const double batched_ns = time_ns([&] {
+        visible_count = culler.cull(frustum, visible);
+    }, 200);
+    const double scalar_ns = time_ns([&] {
+        size_t visible_boxes = 0;
+        for (const Aabb& box: boxes) {
+            visible_boxes += frustum.intersects(box);
+        }
+        g_sink = g_sink + visible_boxes;
+    }, 200);
+
+    report("SoA batch", batched_ns, boxes.size());
+    report("per box", scalar_ns, boxes.size());
+    std::cout << std::left << std::setw(44) << "culled"
+              << std::right << std::setw(11) << std::fixed << std::setprecision(1)
+              << 100.0 * static_cast<double>(boxes.size() - visible_count) / static_cast<double>(boxes.size())
+              << " %" << std::endl;
+}
+
+// Mountain range of `radius` chunks around a camera standing in a valley, looking
+// along the ridges. Every chunk's block bounds is an occludee and its solid core the
+// occluders; reports how many frustum-visible chunks the depth buffer hides and
+// what a frame of occlusion culling costs.
+void bench_occlusion(const int radius) {
+    const auto height_at = [](const int x, const int z) {
+        const float fx = static_cast<float>(x), fz = static_cast<float>(z);
+        const float ridges = std::abs(std::sin(fx * 0.021f + std::sin(fz * 0.013f) * 1.5f));
+        return 4 + static_cast<int>(26.0f * ridges + 2.0f * std::sin(fz * 0.11f));
+    };
+
+    std::vector<Aabb> bounds;
+    std::vector<Aabb> occluders;
+    for (int chunk_z = -radius; chunk_z < radius; chunk_z++) {
+        for (int chunk_x = -radius; chunk_x < radius; chunk_x++) {
+            DenseChunk chunk;
+            int top = 0;
+            for (int z = 0; z < kChunkSize; z++) {
+                for (int x = 0; x < kChunkSize; x++) {
+                    const int height = height_at(chunk_x * kChunkSize + x, chunk_z * kChunkSize + z);
+                    top = std::max(top, height);
+                    for (int y = 0; y < height; y++) {
+                        chunk.set(x, y, z, 1);
+                    }
+                }
+            }
+            const glm::vec3 origin(static_cast<float>(chunk_x * kChunkSize), 0.0f, static_cast<float>(chunk_z * kChunkSize));
+            bounds.push_back({origin, origin + glm::vec3(kChunkSize, top, kChunkSize)});
+            const auto chunk_occluders = occlusion::chunk_occluders(chunk, origin);
+            occluders.insert(occluders.end(), chunk_occluders.begin(), chunk_occluders.end());
+        }
+    }
+
+    // In the valley at x = 0, eye level just above the ground
+    const glm::vec3 eye(0.0f, static_cast<float>(height_at(0, 0)) + 2.0f, 0.0f);
+    const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.3f, -0.05f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const glm::mat4 view_projection = glm::perspective(glm::radians(45.0f), 1.5f, 0.1f, 1000.0f) * view;
+
+    FrustumCuller frustum_culler;
+    for (const Aabb& box: bounds) {
+        frustum_culler.add(box);
+    }
+    std::vector<std::uint8_t> visible;
+    const size_t in_frustum = frustum_culler.cull(Frustum::from(view_projection), visible);
+
+    OcclusionCuller culler;
+    size_t occluded = 0;
+    const auto frame = [&](JobSystem* jobs) {
+        culler.begin_frame(view_projection);
+        for (const Aabb& occluder: occluders) {
+            culler.add_occluder(occluder);
+        }
+        culler.rasterize(jobs);
+        occluded = 0;
+        for (size_t i = 0; i < bounds.size(); i++) {
+            occluded += visible[i] && !culler.is_visible(bounds[i]);
+        }
+    };
+
+    JobSystem jobs;
+    report("frame, serial", time_ns([&] { frame(nullptr); }, 50), bounds.size());
+    report("frame, " + std::to_string(jobs.worker_count()) + " workers", time_ns([&] { frame(&jobs); }, 50),
+           bounds.size());
+    std::cout << std::left << std::setw(44) << "occluder triangles"
+              << std::right << std::setw(12) << culler.occluder_triangles() << std::endl;
+    std::cout << std::left << std::setw(44) << ("chunks in frustum of " + std::to_string(bounds.size()))
+              << std::right << std::setw(12) << in_frustum << std::endl;
+    std::cout << std::left << std::setw(44) << "of those occluded"
+              << std::right << std::setw(11) << std::fixed << std::setprecision(1)
+              << 100.0 * static_cast<double>(occluded) / static_cast<double>(std::max<size_t>(in_frustum, 1))
+              << " %" << std::endl;
+}
+
+// Underground world: solid rock with a few sealed caverns per chunk, crossed by two
+// tunnels that meet ahead of the camera, which stands in one of them.
+void bench_cave_culling(const int radius, const int layers) {
+    const auto open_at = [](const int x, const int y, const int z) {
+        const bool in_band = y >= 44 && y < 48;
+        return in_band && ((x >= 14 && x < 18) || (z >= -200 && z < -196));
+    };
+    const auto fill = [&](DenseChunk& chunk, const ChunkPos& position) {
+        std::mt19937 rng(static_cast<std::uint32_t>(ChunkPosHash{}(position)));
+        std::uniform_int_distribution<int> center(5, kChunkSize - 6);
+        std::vector<glm::ivec3> pockets(3);
+        for (glm::ivec3& pocket: pockets) {
+            pocket = {center(rng), center(rng), center(rng)};
+        }
+        for (int y = 0; y < kChunkSize; y++) {
+            for (int z = 0; z < kChunkSize; z++) {
+                for (int x = 0; x < kChunkSize; x++) {
+                    const glm::ivec3 world = position * kChunkSize + glm::ivec3(x, y, z);
+                    bool open = open_at(world.x, world.y, world.z);
+                    for (const glm::ivec3& pocket: pockets) {
+                        const glm::ivec3 d = glm::ivec3(x, y, z) - pocket;
+                        open = open || d.x * d.x + d.y * d.y + d.z * d.z <= 16;
+                    }
+                    chunk.set(x, y, z, open ? kAir : BlockId{1});
+                }
+            }
+        }
+    };
+
+    DenseChunk chunk;
+    fill(chunk, {4, 0, 4});
+    report("connectivity, sealed rock", time_ns([&] {
+        g_sink = g_sink + visibility::compute(chunk).closed();
+    }, 50), DenseChunk::kVolume);
+    fill(chunk, {0, 1, 0});
+    report("connectivity, tunnel", time_ns([&] {
+        g_sink = g_sink + visibility::compute(chunk).closed();
+    }, 50), DenseChunk::kVolume);
+
+    std::unordered_map<ChunkPos, ChunkVisibility, ChunkPosHash> world;
+    for (int y = 0; y < layers; y++) {
+        for (int z = -radius; z < radius; z++) {
+            for (int x = -radius; x < radius; x++) {
+                fill(chunk, {x, y, z});
+                world[{x, y, z}] = visibility::compute(chunk);
+            }
+        }
+    }
+
+    const glm::vec3 eye(16.0f, 46.0f, 0.0f);
+    const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.2f, -0.1f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = Frustum::from(glm::perspective(glm::radians(45.0f), 1.5f, 0.1f, 1000.0f) * view);
+
+    size_t in_frustum = 0;
+    for (const auto& [position, visibility]: world) {
+        const glm::vec3 low = glm::vec3(position) * static_cast<float>(kChunkSize);
+        in_frustum += frustum.intersects(Aabb{low, low + static_cast<float>(kChunkSize)});
+    }
+
+    size_t visited = 0;
+    const auto visibility_of = [&](const ChunkPos& position, ChunkVisibility& out) {
+        const auto it = world.find(position);
+        if (it == world.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    };
+    report("traversal", time_ns([&] {
+        visited = visibility::traverse({0, 1, 0}, frustum, glm::vec3(0.0f), visibility_of, [](const ChunkPos&) {});
+    }, 200), world.size());
+    std::cout << std::left << std::setw(44) << ("chunks in frustum of " + std::to_string(world.size()))
+              << std::right << std::setw(12) << in_frustum << std::endl;
+    std::cout << std::left << std::setw(44) << "of those reached through open faces"
+              << std::right << std::setw(12) << visited << std::endl;
+}
+
+// Per-frame walk over every renderable: GameObjects with heap-allocated components
+// versus the same data in an EntityRegistry.
+void bench_entities(const int count) {
+    const MeshHandle mesh = MeshRegistry::shared().create_unique({{0.0f, 0.0f, 0.0f}}, {0, 0, 0});
+
+    std::vector<std::unique_ptr<GameObject>> objects;
+    EntityRegistry registry;
+    for (int i = 0; i < count; i++) {
+        const glm::vec3 position(static_cast<float>(i), 0.0f, 0.0f);
+        auto object = std::make_unique<GameObject>();
+        object->transform.set_position(position);
+        object->add_component(std::make_unique<MeshComponent>(mesh));
+        objects.push_back(std::move(object));
+
+        const Entity entity = registry.create();
+        registry.add_component<Transform>(entity, Transform::of(position));
+        registry.add_component<MeshComponent>(entity, mesh);
+    }
+
+    report("game objects, get_component", time_ns([&] {
+        float sum = 0.0f;
+        for (const auto& object: objects) {
+            if (const auto* component = object->get_component<MeshComponent>()) {
+                sum += object->transform.position().x * component->color.a;
+            }
+        }
+        g_sink = g_sink + static_cast<std::uint64_t>(sum);
+    }, 100), objects.size());
+    report("registry, view<Transform, MeshComponent>", time_ns([&] {
+        float sum = 0.0f;
+        registry.view<Transform, MeshComponent>().each([&](Entity, const Transform& transform, const MeshComponent& component) {
+            sum += transform.position().x * component.color.a;
+        });
+        g_sink = g_sink + static_cast<std::uint64_t>(sum);
+    }, 100), registry.size());
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(count - 1));
+    std::vector<Entity> lookups(4096);
+    for (Entity& entity: lookups) {
+        entity = {pick(rng), 0};
+    }
+    report("registry, random get_component", time_ns([&] {
+        float sum = 0.0f;
+        for (const Entity entity: lookups) {
+            sum += registry.get_component<Transform>(entity)->position().x;
+        }
+        g_sink = g_sink + static_cast<std::uint64_t>(sum);
+    }, 100), lookups.size());
+}
+
+// Model matrices of `count` rotated, scaled transforms: composed with glm one at a
+// time, rebuilt lazily by matrix(), and rebuilt in SoA blocks by update_matrices().
+void bench_transforms(const int count) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<Transform> transforms;
+    for (int i = 0; i < count; i++) {
+        const glm::quat rotation = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+        transforms.emplace_back(glm::vec3(unit(rng), unit(rng), unit(rng)) * 100.0f, rotation, glm::vec3(1.0f + unit(rng)));
+    }
+    const auto touch_all = [&] {
+        for (Transform& transform: transforms) {
+            transform.set_scale(transform.scale());
+        }
+    };
+
+    report("glm translate * mat4_cast * scale", time_ns([&] {
+        float sum = 0.0f;
+        for (const Transform& transform: transforms) {
+            const glm::mat4 model = glm::translate(glm::mat4(1.0f), transform.position())
+                * glm::mat4_cast(transform.rotation()) * glm::scale(glm::mat4(1.0f), transform.scale());
+            sum += model[0][0] + model[3][0];
+        }
+        g_sink = g_sink + static_cast<std::uint64_t>(sum);
+    }, 20), transforms.size());
+    report("matrix(), all dirty", time_ns([&] {
+        touch_all();
+        float sum = 0.0f;
+        for (const Transform& transform: transforms) {
+            sum += transform.matrix()[0][0];
+        }
+        g_sink = g_sink + static_cast<std::uint64_t>(sum);
+    }, 20), transforms.size());
+    report("update_matrices, all dirty", time_ns([&] {
+        touch_all();
+        transforms::update_matrices(transforms);
+    }, 20), transforms.size());
+    report("update_matrices, 1% dirty", time_ns([&] {
+        for (size_t i = 0; i < transforms.size(); i += 100) {
+            transforms[i].set_scale(transforms[i].scale());
+        }
+        transforms::update_matrices(transforms);
+    }, 20), transforms.size());
+}
+
+// Vertex memory of one chunk mesh in the packed format, against the float position
+// plus color vertices the meshers emitted before.
+void bench_vertex_format() {
+    auto chunk = std::make_unique<DenseChunk>();
+    fill_terrain(*chunk, 5);
+
+    ChunkMeshBuilder builder;
+    meshing::mesh_chunk(*chunk, meshing::MesherBackend::Greedy, builder);
+    const MeshHandle mesh = builder.build();
+
+    const size_t vertices = mesh->vertex_count();
+    const size_t float_bytes = vertices * (sizeof(glm::vec3) + sizeof(Color));
+    const size_t packed_bytes = vertices * sizeof(PackedVertex);
+    const size_t index_bytes = mesh->indices.size() * sizeof(unsigned int);
+    std::cout << std::left << std::setw(44) << "vertices (greedy caves)"
+              << std::right << std::setw(12) << vertices << std::endl;
+    std::cout << std::left << std::setw(44) << "float vertex + index bytes"
+              << std::right << std::setw(12) << float_bytes + index_bytes
+              << " (" << sizeof(glm::vec3) + sizeof(Color) << " B/vertex)" << std::endl;
+    std::cout << std::left << std::setw(44) << "packed vertex + index bytes"
+              << std::right << std::setw(12) << packed_bytes + index_bytes
+              << " (" << sizeof(PackedVertex) << " B/vertex)" << std::endl;
+}
+
+// A UV sphere of `rings` x `segments` quads, split into triangles row by row.
+void make_sphere(const int rings, const int segments, std::vector<glm::vec3>& vertices,
+                 std::vector<unsigned int>& indices) {
+    for (int r = 0; r <= rings; r++) {
+        const float theta = std::numbers::pi_v<float> * static_cast<float>(r) / static_cast<float>(rings);
+        for (int s = 0; s <= segments; s++) {
+            const float phi = 2.0f * std::numbers::pi_v<float> * static_cast<float>(s) / static_cast<float>(segments);
+            vertices.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+        }
+    }
+    const auto at = [&](const int r, const int s) { return static_cast<unsigned int>(r * (segments + 1) + s); };
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            indices.insert(indices.end(), {at(r, s), at(r + 1, s), at(r + 1, s + 1), at(r + 1, s + 1), at(r, s + 1), at(r, s)});
+        }
+    }
+}
+
+// Cache statistics of a sphere before and after mesh_optimizer, in authored (row)
+// order and with its triangles shuffled like an arbitrarily exported mesh.
+void bench_mesh_optimizer(const int rings, const int segments) {
+    std::vector<glm::vec3> sphere;
+    std::vector<unsigned int> rows;
+    make_sphere(rings, segments, sphere, rows);
+
+    std::vector<unsigned int> shuffled = rows;
+    {
+        std::vector<size_t> order(shuffled.size() / 3);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::mt19937(99));
+        for (size_t t = 0; t < order.size(); t++) {
+            std::copy_n(rows.begin() + static_cast<std::ptrdiff_t>(order[t] * 3), 3,
+                        shuffled.begin() + static_cast<std::ptrdiff_t>(t * 3));
+        }
+    }
+
+    const size_t triangles = rows.size() / 3;
+    for (const auto& [label, source]: {std::pair{"authored", &rows}, std::pair{"shuffled", &shuffled}}) {
+        mesh_optimizer::Report result;
+        const auto start = Clock::now();
+        std::vector<glm::vec3> vertices = sphere;
+        std::vector<unsigned int> indices = *source;
+        std::vector<Color> colors;
+        result = mesh_optimizer::optimize(vertices, indices, colors);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout << std::left << std::setw(44) << (std::string(label) + " ACMR (before / after)")
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(3)
+                  << result.before.acmr << " / " << result.after.acmr << std::endl;
+        std::cout << std::left << std::setw(44) << (std::string(label) + " ATVR (before / after)")
+                  << std::right << std::setw(12) << result.before.atvr << " / " << result.after.atvr << std::endl;
+        std::cout << std::left << std::setw(44) << (std::string(label) + " optimize, " + std::to_string(triangles) + " triangles")
+                  << std::right << std::setw(12) << std::setprecision(1) << ms << " ms" << std::endl;
+    }
+}
+
+// Quads and meshing time of one terrain chunk per level of detail, and the quads
+// of a full view of `radius` chunks with LOD from `lod_distance` chunks on.
+void bench_lod(const int radius, const float lod_distance) {
+    auto chunk = std::make_unique<DenseChunk>();
+    fill_terrain(*chunk, 0);
+
+    std::array<size_t, lod::kLevels> quads{};
+    for (int level = 0; level < lod::kLevels; level++) {
+        ChunkMeshBuilder builder;
+        const std::string name = "hills LOD " + std::to_string(level) + " (" + std::to_string(1 << level) + "x)";
+        report(name + " mesh", time_ns([&] {
+            builder.clear();
+            lod::mesh_chunk(*chunk, level, meshing::MesherBackend::Binary, builder);
+        }, 50), DenseChunk::kVolume);
+        quads[level] = builder.quad_count();
+        std::cout << std::left << std::setw(44) << (name + " quads")
+                  << std::right << std::setw(12) << quads[level] << std::endl;
+    }
+
+    size_t full = 0;
+    size_t reduced = 0;
+    for (int z = -radius; z <= radius; z++) {
+        for (int x = -radius; x <= radius; x++) {
+            if (x * x + z * z > radius * radius) {
+                continue;
+            }
+            const float distance = std::sqrt(static_cast<float>(x * x + z * z));
+            full += quads[0];
+            reduced += quads[lod::level_for(distance, lod_distance)];
+        }
+    }
+    std::cout << std::left << std::setw(44) << ("view radius " + std::to_string(radius) + " quads (full / LOD)")
+              << std::right << std::setw(12) << full << " / " << reduced
+              << " (" << std::setprecision(1) << static_cast<double>(full) / static_cast<double>(reduced) << "x)"
+              << std::endl;
+}
+
+// A `chunks_x` x `chunks_y` x `chunks_z` chunk world of rolling terrain stored in a
+// SparseVoxelOctree: memory against dense and paletted chunks, then point, box and
+// chunk queries.
+void bench_octree(const int chunks_x, const int chunks_y, const int chunks_z) {
+    const int extent = std::max({chunks_x, chunks_y, chunks_z}) * kChunkSize;
+    SparseVoxelOctree world(std::bit_width(static_cast<unsigned>(extent - 1)));
+
+    Clock::duration build_time{};
+    size_t paletted_bytes = 0;
+    auto chunk = std::make_unique<DenseChunk>();
+    for (int cz = 0; cz < chunks_z; cz++) {
+        for (int cx = 0; cx < chunks_x; cx++) {
+            for (int cy = 0; cy < chunks_y; cy++) {
+                for (int z = 0; z < kChunkSize; z++) {
+                    for (int x = 0; x < kChunkSize; x++) {
+                        const float wx = static_cast<float>(cx * kChunkSize + x);
+                        const float wz = static_cast<float>(cz * kChunkSize + z);
+                        const int height = 48 + static_cast<int>(20.0f * std::sin(wx * 0.02f) * std::cos(wz * 0.03f)
+                                                                  + 4.0f * std::sin(wx * 0.11f + wz * 0.07f));
+                        for (int y = 0; y < kChunkSize; y++) {
+                            const int wy = cy * kChunkSize + y;
+                            chunk->set(x, y, z, wy < height - 3 ? kStone : wy < height - 1 ? kDirt : wy < height ? kGrass : kAir);
+                        }
+                    }
+                }
+                paletted_bytes += CompactChunk::from_dense(*chunk).memory_usage();
+                const auto start = Clock::now();
+                world.write_chunk({cx, cy, cz}, *chunk);
+                build_time += Clock::now() - start;
+            }
+        }
+    }
+    const double build_ms = std::chrono::duration<double, std::milli>(build_time).count();
+
+    const size_t chunk_count = static_cast<size_t>(chunks_x) * chunks_y * chunks_z;
+    std::cout << std::left << std::setw(44) << ("dense bytes (" + std::to_string(chunk_count) + " chunks)")
+              << std::right << std::setw(12) << chunk_count * sizeof(DenseChunk) << std::endl;
+    std::cout << std::left << std::setw(44) << "paletted bytes"
+              << std::right << std::setw(12) << paletted_bytes << std::endl;
+    std::cout << std::left << std::setw(44) << "octree bytes"
+              << std::right << std::setw(12) << world.memory_usage() << " (" << world.node_count() << " nodes)" << std::endl;
+    std::cout << std::left << std::setw(44) << "octree write_chunk, all chunks"
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << build_ms << " ms" << std::endl;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> along_x(0, chunks_x * kChunkSize - 1);
+    std::uniform_int_distribution<int> along_y(0, chunks_y * kChunkSize - 1);
+    std::uniform_int_distribution<int> along_z(0, chunks_z * kChunkSize - 1);
+    std::vector<glm::ivec3> points(1 << 16);
+    for (glm::ivec3& p: points) {
+        p = {along_x(rng), along_y(rng), along_z(rng)};
+    }
+    report("octree random get", time_ns([&] {
+        std::uint64_t sum = 0;
+        for (const glm::ivec3& p: points) {
+            sum += world.get(p);
+        }
+        g_sink = g_sink + sum;
+    }, 20), points.size());
+    report("octree uniform() per chunk", time_ns([&] {
+        size_t uniform = 0;
+        for (int cz = 0; cz < chunks_z; cz++) {
+            for (int cy = 0; cy < chunks_y; cy++) {
+                for (int cx = 0; cx < chunks_x; cx++) {
+                    const glm::ivec3 min = glm::ivec3(cx, cy, cz) * kChunkSize;
+                    uniform += world.uniform(min, min + kChunkSize).has_value() ? 1 : 0;
+                }
+            }
+        }
+        g_sink = g_sink + uniform;
+    }, 20), chunk_count);
+    report("octree read_chunk per chunk", time_ns([&] {
+        for (int cz = 0; cz < chunks_z; cz++) {
+            for (int cx = 0; cx < chunks_x; cx++) {
+                world.read_chunk({cx, 1, cz}, *chunk);
+                g_sink = g_sink + chunk->get(0, 0, 0);
+            }
+        }
+    }, 5), static_cast<size_t>(chunks_x) * chunks_z);
+}
+}
+
+// Streams a world of `radius` x `layers` chunks, then edits blocks while every
+// resident chunk is queued for a background remesh, timing the update() that makes
+// each batch of edits visible.
+void bench_edits(const int radius, const int layers) {
+    auto terrain = std::make_shared<DenseChunk>();
+    fill_terrain(*terrain, 5);
+    JobSystem jobs;
+    ChunkMeshScheduler scheduler(jobs, meshing::MesherBackend::Binary);
+    ChunkStreamer::Config config;
+    config.view_radius = radius;
+    config.max_chunk_y = layers - 1;
+    config.cpu_budget_bytes = size_t{4} << 30;
+    config.gpu_budget_bytes = size_t{4} << 30;
+    config.max_results_per_update = 64;
+    ChunkStreamer streamer(jobs, scheduler, [&](const ChunkPos&) {
+        return std::make_shared<DenseChunk>(*terrain);
+    }, config);
+
+    const glm::vec3 camera(16.0f, 16.0f, 16.0f);
+    const auto load_start = Clock::now();
+    do {
+        streamer.update(camera);
+        std::this_thread::yield();
+    } while (streamer.generating() > 0 || scheduler.queued() > 0 || scheduler.in_flight() > 0);
+    const double load_ms = std::chrono::duration<double, std::milli>(Clock::now() - load_start).count();
+    std::cout << std::left << std::setw(44) << ("load " + std::to_string(streamer.resident_chunks()) + " chunks")
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << load_ms << " ms" << std::endl;
+
+    // Background work the edits have to overtake
+    streamer.remesh_all();
+    streamer.update(camera);
+
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> coordinate(-64, 95);
+    const auto measure = [&](const std::string& name, const int brush) {
+        constexpr int kFrames = 200;
+        double total_us = 0.0;
+        double worst_us = 0.0;
+        double remesh_total_us = 0.0;
+        double remesh_worst_us = 0.0;
+        size_t chunks = 0;
+        for (int frame = 0; frame < kFrames; frame++) {
+            const glm::ivec3 center(coordinate(rng), 10 + frame % 12, coordinate(rng));
+            for (int y = 0; y < brush; y++) {
+                for (int z = 0; z < brush; z++) {
+                    for (int x = 0; x < brush; x++) {
+                        const glm::ivec3 block = center + glm::ivec3(x, y, z);
+                        streamer.set_block(block, streamer.get_block(block) == kAir ? 1 : kAir);
+                    }
+                }
+            }
+            const auto start = Clock::now();
+            streamer.update(camera);
+            const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            total_us += us;
+            worst_us = std::max(worst_us, us);
+            chunks += streamer.last_edited_chunks();
+            remesh_total_us += streamer.last_edit_time_us();
+            remesh_worst_us = std::max(remesh_worst_us, streamer.last_edit_time_us());
+        }
+        std::cout << std::left << std::setw(44) << (name + ", remesh avg / worst")
+                  << std::right << std::setw(12) << std::setprecision(1) << remesh_total_us / kFrames << " / "
+                  << remesh_worst_us << " us (" << std::setprecision(2) << static_cast<double>(chunks) / kFrames
+                  << " chunks/frame)" << std::endl;
+        std::cout << std::left << std::setw(44) << (name + ", whole update() avg / worst")
+                  << std::right << std::setw(12) << std::setprecision(1) << total_us / kFrames << " / " << worst_us
+                  << " us" << std::endl;
+    };
+    measure("1 block", 1);
+    measure("4x4x4 brush", 4);
+    std::cout << std::left << std::setw(44) << "background remeshes still queued"
+              << std::right << std::setw(12) << scheduler.queued() << std::endl;
+}
+
+// Rays over a `chunks` x `chunks` field of terrain chunks with empty chunks above:
+// picking-style rays aimed at the ground, and rays skimming through the sky, which
+// cross empty chunks in single steps. Traced one by one, then batched on the workers.
+void bench_raycast(const int chunks, const int ray_count) {
+    auto terrain = std::make_shared<DenseChunk>();
+    fill_terrain(*terrain, 5);
+    std::unordered_map<ChunkPos, std::shared_ptr<const DenseChunk>, ChunkPosHash> world;
+    for (int z = 0; z < chunks; z++) {
+        for (int x = 0; x < chunks; x++) {
+            world[{x, 0, z}] = terrain;
+        }
+    }
+    const auto lookup = [&](const ChunkPos& position) -> const DenseChunk* {
+        const auto it = world.find(position);
+        return it != world.end() ? it->second.get() : nullptr;
+    };
+
+    std::mt19937 rng(7);
+    const float extent = static_cast<float>(chunks * kChunkSize);
+    std::uniform_real_distribution<float> across(0.0f, extent);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<raycast::Ray> ground(static_cast<size_t>(ray_count));
+    std::vector<raycast::Ray> sky(static_cast<size_t>(ray_count));
+    for (int i = 0; i < ray_count; i++) {
+        const glm::vec3 origin(across(rng), 40.0f + 20.0f * std::abs(unit(rng)), across(rng));
+        ground[i] = {origin, glm::vec3(unit(rng), -1.0f, unit(rng)), 256.0f};
+        sky[i] = {origin, glm::vec3(unit(rng), 0.1f * std::abs(unit(rng)), unit(rng)), 256.0f};
+    }
+
+    JobSystem jobs;
+    std::vector<std::optional<raycast::Hit>> hits(static_cast<size_t>(ray_count));
+    for (const auto& [name, rays]: {std::pair{"ground", &ground}, std::pair{"sky", &sky}}) {
+        const double serial_ns = time_ns([&] {
+            for (size_t i = 0; i < rays->size(); i++) {
+                hits[i] = raycast::trace((*rays)[i], lookup);
+            }
+        }, 5);
+        const double batched_ns = time_ns([&] {
+            raycast::trace_batch(jobs, *rays, hits, lookup);
+        }, 5);
+        g_sink = g_sink + static_cast<std::uint64_t>(std::ranges::count_if(hits, [](const auto& hit) {
+            return hit.has_value();
+        }));
+        report(std::string(name) + " rays, 1 thread", serial_ns, rays->size());
+        report(std::string(name) + " rays, batched (" + std::to_string(jobs.worker_count()) + " workers)",
+               batched_ns, rays->size());
+        std::cout << std::left << std::setw(44) << (std::string(name) + " rays/s, 1 thread / batched")
+                  << std::right << std::setw(12) << std::setprecision(2)
+                  << static_cast<double>(rays->size()) / serial_ns * 1e3 << " / "
+                  << static_cast<double>(rays->size()) / batched_ns * 1e3 << " M" << std::endl;
+    }
+}
+// Lights a `chunks` x `chunks` field of terrain chunks under a layer of open sky:
+// the initial flood, then single block edits and lamps relit incrementally, and
+// the cost baked light adds to meshing.
+void bench_lighting(const int chunks) {
+    auto terrain = std::make_shared<DenseChunk>();
+    fill_terrain(*terrain, 5);
+    std::unordered_map<ChunkPos, std::shared_ptr<DenseChunk>, ChunkPosHash> world;
+    for (int z = 0; z < chunks; z++) {
+        for (int x = 0; x < chunks; x++) {
+            world[{x, 0, z}] = std::make_shared<DenseChunk>(*terrain);
+        }
+    }
+    const auto lookup = [&](const ChunkPos& position) -> const DenseChunk* {
+        const auto it = world.find(position);
+        return it != world.end() ? it->second.get() : nullptr;
+    };
+
+    JobSystem jobs;
+    LightEngine engine(lookup, 1);
+    const auto start = Clock::now();
+    for (int y = 0; y <= 1; y++) {
+        for (int z = 0; z < chunks; z++) {
+            for (int x = 0; x < chunks; x++) {
+                engine.add_chunk({x, y, z});
+            }
+        }
+    }
+    const size_t stale = engine.propagate(jobs).size();
+    const double initial_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << std::left << std::setw(44) << ("initial light, " + std::to_string(engine.chunk_count()) + " chunks")
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << initial_ms << " ms ("
+              << engine.last_rounds() << " rounds, " << stale << " stale)" << std::endl;
+
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> coordinate(0, chunks * kChunkSize - 1);
+    const auto measure = [&](const std::string& name, const BlockId placed, const int min_y, const int max_y) {
+        constexpr int kEdits = 200;
+        std::uniform_int_distribution<int> height(min_y, max_y);
+        double total_us = 0.0;
+        double worst_us = 0.0;
+        size_t rounds = 0;
+        size_t updates = 0;
+        for (int i = 0; i < kEdits; i++) {
+            const glm::ivec3 block(coordinate(rng), height(rng), coordinate(rng));
+            DenseChunk& chunk = *world.at({block.x / kChunkSize, 0, block.z / kChunkSize});
+            const int x = block.x % kChunkSize;
+            const int z = block.z % kChunkSize;
+            chunk.set(x, block.y, z, chunk.get(x, block.y, z) == placed ? kAir : placed);
+            const auto edit_start = Clock::now();
+            engine.block_changed(block);
+            g_sink = g_sink + engine.propagate(jobs).size();
+            const double us = std::chrono::duration<double, std::micro>(Clock::now() - edit_start).count();
+            total_us += us;
+            worst_us = std::max(worst_us, us);
+            rounds += engine.last_rounds();
+            updates += engine.last_updates();
+        }
+        std::cout << std::left << std::setw(44) << (name + " relight avg / worst")
+                  << std::right << std::setw(12) << std::setprecision(1) << total_us / kEdits << " / " << worst_us
+                  << " us (" << rounds / kEdits << " rounds, " << updates / kEdits << " blocks)" << std::endl;
+    };
+    measure("surface block", 1, kChunkSize / 2 - 6, kChunkSize / 2 + 6);
+    measure("lamp in the open", kLamp, kChunkSize / 2 + 8, kChunkSize - 1);
+
+    LightVolume light;
+    engine.fill_volume({chunks / 2, 0, chunks / 2}, light);
+    const DenseChunk& chunk = *world.at({chunks / 2, 0, chunks / 2});
+    ChunkMeshBuilder builder;
+    report("binary mesh, unlit", time_ns([&] {
+        builder.clear();
+        meshing::mesh_chunk(chunk, meshing::MesherBackend::Binary, builder);
+    }, 50), DenseChunk::kVolume);
+    report("binary mesh, lit", time_ns([&] {
+        builder.clear();
+        meshing::mesh_chunk(chunk, meshing::MesherBackend::Binary, builder, light);
+    }, 50), DenseChunk::kVolume);
+    report("fill light volume", time_ns([&] {
+        engine.fill_volume({chunks / 2, 0, chunks / 2}, light);
+    }, 200), LightVolume::kVolume);
+}
+
+void bench_terrain(const int chunks) {
+    float x[noise::kLanes];
+    float y[noise::kLanes];
+    float z[noise::kLanes];
+    float out[noise::kLanes];
+    for (size_t lane = 0; lane < noise::kLanes; lane++) {
+        x[lane] = 0.37f * static_cast<float>(lane);
+        y[lane] = 1.7f + 0.11f * static_cast<float>(lane);
+        z[lane] = 2.3f - 0.29f * static_cast<float>(lane);
+    }
+    constexpr int kBatches = 4096;
+    report("2D gradient noise", time_ns([&] {
+        for (int i = 0; i < kBatches; i++) {
+            x[i % noise::kLanes] += 0.01f;
+            noise::gradient2(7, x, z, out);
+            g_sink = g_sink + static_cast<std::uint64_t>(out[0] > 0.0f);
+        }
+    }, 20), kBatches * noise::kLanes);
+    report("3D gradient noise", time_ns([&] {
+        for (int i = 0; i < kBatches; i++) {
+            x[i % noise::kLanes] += 0.01f;
+            noise::gradient3(7, x, y, z, out);
+            g_sink = g_sink + static_cast<std::uint64_t>(out[0] > 0.0f);
+        }
+    }, 20), kBatches * noise::kLanes);
+
+    const TerrainGenerator generator(TerrainGenerator::Config{});
+    float heights[kChunkSize * kChunkSize];
+    int column = 0;
+    report("heightmap, 5 octaves", time_ns([&] {
+        generator.heightmap(column++, 0, heights);
+    }, 200), kChunkSize * kChunkSize);
+    int solid = 0;
+    report("solid chunk with caves", time_ns([&] {
+        g_sink = g_sink + static_cast<std::uint64_t>(generator.generate({solid++, 0, 0}) != nullptr);
+    }, 200), DenseChunk::kVolume);
+
+    // Every chunk of the world's height range, empty sky chunks included
+    std::vector<ChunkPos> positions;
+    for (int cy = 0; cy <= 2; cy++) {
+        for (int cz = 0; cz < chunks; cz++) {
+            for (int cx = 0; cx < chunks; cx++) {
+                positions.push_back({cx, cy, cz});
+            }
+        }
+    }
+    std::vector<std::shared_ptr<DenseChunk>> generated(positions.size());
+    const double serial_ns = time_ns([&] {
+        for (size_t i = 0; i < positions.size(); i++) {
+            generated[i] = generator.generate(positions[i]);
+        }
+    }, 2);
+    report(std::to_string(positions.size()) + " chunks, 1 thread", serial_ns, positions.size());
+
+    JobSystem jobs;
+    const double parallel_ns = time_ns([&] {
+        jobs.parallel_for(positions.size(), [&](const size_t i) {
+            generated[i] = generator.generate(positions[i]);
+        });
+    }, 2);
+    report(std::to_string(positions.size()) + " chunks, " + std::to_string(jobs.worker_count()) + " workers",
+           parallel_ns, positions.size());
+    std::cout << std::left << std::setw(44) << "chunks/s, 1 thread / workers"
+              << std::right << std::setw(12) << std::setprecision(0) << 1e9 * static_cast<double>(positions.size()) / serial_ns
+              << " / " << 1e9 * static_cast<double>(positions.size()) / parallel_ns << std::endl;
+
+    // A fresh generator with the same seed must reproduce every block
+    const TerrainGenerator again(TerrainGenerator::Config{});
+    size_t mismatches = 0;
+    for (size_t i = 0; i < positions.size(); i++) {
+        const auto chunk = again.generate(positions[i]);
+        if ((chunk == nullptr) != (generated[i] == nullptr)
+            || (chunk && !std::ranges::equal(chunk->data(), generated[i]->data()))) {
+            mismatches++;
+        }
+    }
+    std::cout << std::left << std::setw(44) << "chunks differing on regeneration"
+              << std::right << std::setw(12) << mismatches << std::endl;
+}
+
+
+int main() {
+    std::cout << "Chunk layouts (" << kChunkSize << "^3)" << std::endl;
+    bench_layout<Chunk<kChunkSize, BlockId, YMajorLayout>>("y-major");
+    bench_layout<Chunk<kChunkSize, BlockId, MortonLayout>>("morton");
+    bench_layout<Chunk<kChunkSize, BlockId, YMajorLayout, 1>>("y-major padded");
+    bench_layout<Chunk<kChunkSize, BlockId, MortonLayout, 1>>("morton padded");
+
+    std::cout << std::endl << "Chunk storage (" << kChunkSize << "^3)" << std::endl;
+    bench_storage<DenseChunk>("dense");
+    bench_storage<CompactChunk>("paletted");
+    std::cout << std::left << std::setw(44) << "paletted uniform memory"
+              << std::right << std::setw(12) << CompactChunk(kAir).memory_usage() << " bytes" << std::endl;
+
+    std::cout << std::endl << "Meshing (" << kChunkSize << "^3)" << std::endl;
+    bench_mesher<DenseChunk>("dense hills", 0);
+    bench_mesher<DenseChunk>("dense caves", 5);
+    bench_mesher<CompactChunk>("paletted caves", 5);
+    bench_vertex_format();
+
+    std::cout << std::endl << "Level of detail" << std::endl;
+    bench_lod(24, 4.0f);
+
+    std::cout << std::endl << "Sparse voxel octree (16x8x16 chunks)" << std::endl;
+    bench_octree(16, 8, 16);
+
+    std::cout << std::endl << "Background meshing" << std::endl;
+    bench_scheduler(256);
+
+    std::cout << std::endl << "Voxel raycast" << std::endl;
+    bench_raycast(16, 100000);
+
+    std::cout << std::endl << "Lighting (16x16 chunks)" << std::endl;
+    bench_lighting(16);
+
+    std::cout << std::endl << "Terrain generation" << std::endl;
+    bench_terrain(16);
+
+    std::cout << std::endl << "Block edits" << std::endl;
+    bench_edits(16, 4);
+
+    std::cout << std::endl << "Region files" << std::endl;
+    bench_region();
+
+    std::cout << std::endl << "Frustum culling (10k boxes, 45 degree FOV)" << std::endl;
+    bench_culling(10000);
+
+    std::cout << std::endl << "Occlusion culling (" << 256 / 8 << "x" << 128 / 8 << " hierarchical depth)" << std::endl;
+    bench_occlusion(12);
+
+    std::cout << std::endl << "Cave culling" << std::endl;
+    bench_cave_culling(12, 4);
+
+    std::cout << std::endl << "Entities" << std::endl;
+    bench_entities(100000);
+
+    std::cout << std::endl << "Transforms" << std::endl;
+    bench_transforms(100000);
+
+    std::cout << std::endl << "Mesh optimization (FIFO cache of " << mesh_optimizer::kCacheSize << ")" << std::endl;
+    bench_mesh_optimizer(256, 512);
+    return 0;
+}
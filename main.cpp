@@ -1,14 +1,38 @@
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
 #include "glm/gtx/io.hpp"
 #include "src/Cube.h"
 #include "src/MouseKeyboardMovementComponent.h"
 #include "src/OpenGLDebug.h"
 #include "imgui.h"
-#include "glm/gtc/type_ptr.hpp"
+#include "glm/gtc/matrix_transform.hpp"
 #include "src/ImguiImplementation.h"
 #include "src/MeshComponent.h"
+#include "src/Renderer.h"
+#include "src/CameraPath.h"
+#include "src/Chunk.h"
+#include "src/ChunkMesher.h"
+#include "src/ChunkMeshScheduler.h"
+#include "src/ChunkStore.h"
+#include "src/ChunkStreamer.h"
+#include "src/EntityRegistry.h"
+#include "src/FrameProfiler.h"
+#include "src/Frustum.h"
+#include "src/JobSystem.h"
+#include "src/OcclusionCuller.h"
+#include "src/OffscreenFramebuffer.h"
+#include "src/SystemScheduler.h"
+#include "src/TerrainGenerator.h"
 
 using GLFWWindowPtr = std::unique_ptr<GLFWwindow, decltype(&glfwDestroyWindow)>;
 
@@ -29,66 +53,8 @@ void framebufferSizeCallback(GLFWwindow* window, const int width, const int heig
     glViewport(0, 0, width, height);
 }
 
-void setupPerspectiveProjection(GLFWwindow* window, const GLfloat fov, const GLfloat nearPlane, const GLfloat farPlane) {
-    // int width, height;
-    // glfwGetFramebufferSize(window, &width, &height);
-    constexpr int width = 640;
-    constexpr int height = 480;
-
-    // Calculate aspect ratio
-    constexpr GLfloat aspectRatio = static_cast<GLfloat>(width) / static_cast<GLfloat>(height);
-
-    // Convert fov from degrees to radians
-    const GLfloat fovRadians = fov / 2.0f * static_cast<GLfloat>(M_PI) / 180.0f;
-
-    const GLfloat sine = sin(fovRadians);
-    const GLfloat deltaZ = farPlane - nearPlane;
-
-    if (deltaZ == 0 || sine == 0 || aspectRatio == 0) {
-        std::cerr << "Invalid projection parameters" << std::endl;
-        return;
-    }
-
-    const GLfloat cotangent = cos(fovRadians) / sine;
-
-    const float top = nearPlane * std::tan(fovRadians / 2.0f);
-    const float right = top * aspectRatio;
-    const float left = -right;
-    const float bottom = -top;
-
-    std::cout << "Projection Top: " << top
-        << " Right: " << right
-        << " Left: " << left
-        << " Bottom: " << bottom
-        << std::endl;
-
-    // Construct the perspective projection matrix
-    const float projectionMatrix[16] = {
-        cotangent / aspectRatio,
-        0.0f,
-        0.0f,
-        0.0f,
-        0.0f,
-        cotangent,
-        0.0f,
-        0.0f,
-        // 0.0f, 0.0f, -(farPlane + nearPlane) / deltaZ, -1.0f,
-        0.0f,
-        0.0f,
-        -(farPlane + nearPlane) / deltaZ,
-        2 * farPlane * nearPlane / deltaZ,
-        0.0f,
-        0.0f,
-        -2.0f * farPlane * nearPlane / deltaZ,
-        0.0f
-    };
-
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glLoadMatrixf(projectionMatrix);
-}
-
-auto initializeOpenGL(const int windowWidth, const int windowHeight) {
+// A hidden window without vsync renders as fast as it can, for benchmarks
+auto initializeOpenGL(const int windowWidth, const int windowHeight, const bool hidden) {
     // Initialize GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -100,6 +66,13 @@ auto initializeOpenGL(const int windowWidth, const int windowHeight) {
     // Set error callback
     glfwSetErrorCallback(errorCallback);
 
+    // Request a core profile context; forward compatibility is required on macOS
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, hidden ? GLFW_FALSE : GLFW_TRUE);
+
     // Create a window
     GLFWwindow* window = glfwCreateWindow(windowWidth, windowHeight, "Chunk Preview", nullptr, nullptr);
     if (!window) {
@@ -113,7 +86,7 @@ auto initializeOpenGL(const int windowWidth, const int windowHeight) {
     glfwMakeContextCurrent(window);
 
     // Enable vsync
-    glfwSwapInterval(1);
+    glfwSwapInterval(hidden ? 0 : 1);
 
     glDisable(GL_CULL_FACE);
     glEnable(GL_DEPTH_TEST);
@@ -131,8 +104,7 @@ auto initializeOpenGL(const int windowWidth, const int windowHeight) {
     return GLFWWindowPtr(window, glfwDestroyWindow);
 }
 
-std::vector<GameObject> game_objects() {
-    std::vector<GameObject> objects = std::vector<GameObject>();
+void populate_scene(EntityRegistry& scene) {
     std::vector<glm::vec3> cube_vertices = {
         // Front face
         {-0.5f, -0.5f,  0.5f},
@@ -161,26 +133,89 @@ std::vector<GameObject> game_objects() {
         0, 1, 5, 5, 4, 0
     };
 
-    MeshComponent cube_mesh = MeshComponent(cube_vertices, cube_indices);
+    // Registered once; every cube below holds a reference to the same geometry
+    const MeshHandle cube_mesh = MeshRegistry::shared().get_or_create(cube_vertices, cube_indices);
 
     for (int x = 0; x < 10; x++) {
         for (int y = 0; y < 10; y++) {
             for (int z = 0; z < 1; z++) {
-                auto cube = GameObject();
-                cube.add_component(std::make_unique<MeshComponent>(cube_vertices, cube_indices));
-                cube.transform.position = glm::vec3(x, y, z) * 20.0f;
-                objects.push_back(cube);
+                const Entity cube = scene.create();
+                scene.add_component<Transform>(cube, Transform::of(glm::vec3(x, y, z) * 20.0f, 5.0f));
+                scene.add_component<MeshComponent>(cube, cube_mesh);
             }
         }
     }
-
-    return objects;
 }
 
 int main(int argc, char* argv[]) {
+    // `--world <directory>` loads chunks from region files there and saves newly generated ones;
+    // `--seed <number>` picks the generated terrain.
+    // `--bench` flies the camera along `--camera-path <file>` (by default a scripted flight)
+    // offscreen without vsync, then writes the frame timings to `--bench-output <prefix>`
+    // .json and .csv; `--record-path <file>` saves the flight of an interactive session
+    // as such a path.
+    std::unique_ptr<ChunkStore> world;
+    TerrainGenerator::Config terrain_config;
+    bool bench = false;
+    std::string camera_path_file;
+    std::string record_path_file;
+    std::string bench_output = "bench";
+    for (int i = 1; i < argc; i++) {
+        const std::string_view option(argv[i]);
+        if (option == "--bench") {
+            bench = true;
+            continue;
+        }
+        if (option != "--world" && option != "--seed" && option != "--camera-path" && option != "--record-path"
+            && option != "--bench-output") {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << option << " expects a value" << std::endl;
+            return 1;
+        }
+        const std::string_view value(argv[++i]);
+        if (option == "--world") {
+            try {
+                world = std::make_unique<ChunkStore>(argv[i]);
+            } catch (const std::runtime_error& error) {
+                std::cerr << error.what() << std::endl;
+                return 1;
+            }
+        } else if (option == "--seed") {
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), terrain_config.seed);
+            if (error != std::errc{} || end != value.data() + value.size()) {
+                std::cerr << "--seed expects a number from 0 to " << UINT32_MAX << ", not " << value << std::endl;
+                return 1;
+            }
+        } else if (option == "--camera-path") {
+            camera_path_file = value;
+        } else if (option == "--record-path") {
+            record_path_file = value;
+        } else {
+            bench_output = value;
+        }
+    }
+    const auto terrain = std::make_shared<const TerrainGenerator>(terrain_config);
+
+    CameraPath camera_path = CameraPath::flyover();
+    if (!camera_path_file.empty()) {
+        try {
+            camera_path = CameraPath::load(camera_path_file);
+        } catch (const std::runtime_error& error) {
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        if (camera_path.empty()) {
+            std::cerr << "Camera path " << camera_path_file << " has no keyframes" << std::endl;
+            return 1;
+        }
+    }
+
     constexpr int window_width = 1200;
     constexpr int window_height = 800;
-    GLFWWindowPtr window = initializeOpenGL(window_width, window_height);
+    GLFWWindowPtr window = initializeOpenGL(window_width, window_height, bench);
     if (!window) {
         std::cerr << "Failed to initialize OpenGL" << std::endl;
         return 1;
@@ -188,11 +223,21 @@ int main(int argc, char* argv[]) {
 
     ui::initImGui(window.get());
 
+    auto renderer = std::make_unique<Renderer>();
+
     // Print OpenGL version info for debugging
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
     std::cout << "OpenGL Vendor: " << glGetString(GL_VENDOR) << std::endl;
     std::cout << "OpenGL Renderer: " << glGetString(GL_RENDERER) << std::endl;
 
+    // Benchmarks render at a fixed resolution into their own framebuffer and time every frame
+    std::unique_ptr<OffscreenFramebuffer> offscreen;
+    std::unique_ptr<FrameProfiler> profiler;
+    if (bench) {
+        offscreen = std::make_unique<OffscreenFramebuffer>(window_width, window_height);
+        profiler = std::make_unique<FrameProfiler>();
+    }
+
     constexpr float scale = 10.0f;
     constexpr float z_offset = 50.0f;
     const std::array cubes = {
@@ -224,8 +269,8 @@ int main(int argc, char* argv[]) {
         // Pass events to ImGui
         ImGui_ImplGlfw_KeyCallback(window, key, scancode, action, mods);
 
-        // Check if ImGui wants to capture keyboard
-        if (ImGui::GetIO().WantCaptureKeyboard) {
+        // Check if ImGui wants to capture keyboard; releases still go through so no key stays held
+        if (ImGui::GetIO().WantCaptureKeyboard && action != GLFW_RELEASE) {
             return;
         }
 
@@ -255,32 +300,146 @@ int main(int argc, char* argv[]) {
     GameObject camera{};
     camera.add_component(std::move(movement_component));
 
-    auto objects = game_objects();
+    EntityRegistry scene;
+    populate_scene(scene);
+
+    // Terrain around the camera is generated and meshed on worker threads; the world
+    // store is declared first so it outlives jobs still running at shutdown
+    JobSystem jobs;
+    ChunkMeshScheduler mesh_scheduler(jobs);
+    ChunkStreamer::Config streaming;
+    // Distant chunks are meshed at reduced detail, which pays for the larger radius
+    streaming.view_radius = 24;
+    streaming.lod_distance = 4.0f;
+    // Three chunks of height hold the hills; the camera starts above the highest peaks
+    streaming.max_chunk_y = 2;
+    streaming.origin = glm::vec3(0.0f, -96.0f, -60.0f);
+    ChunkStreamer::Generator generator = [terrain](const ChunkPos& position) {
+        return terrain->generate(position);
+    };
+    if (world) {
+        generator = [store = world.get(), terrain](const ChunkPos& position) {
+            if (auto chunk = store->load(position)) {
+                return chunk;
+            }
+            auto chunk = terrain->generate(position);
+            if (chunk) {
+                store->save(position, *chunk);
+            }
+            return chunk;
+        };
+    }
+    // Without a world to save to, edited chunks stay resident instead
+    ChunkStreamer::Saver saver;
+    if (world) {
+        saver = [store = world.get()](const ChunkPos& position, const DenseChunk& chunk) {
+            store->save(position, chunk);
+        };
+    }
+    ChunkStreamer streamer(jobs, mesh_scheduler, generator, streaming, saver);
+    auto mesher_backend = mesh_scheduler.backend();
+
+    OcclusionCuller occlusion;
+    bool occlusion_culling = true;
+
+    // Update phase: systems that touch different data run in parallel on the workers
+    SystemScheduler systems(jobs);
+    // Benchmarks replace the input-driven movement with the camera path
+    float path_time = 0.0f;
+    systems.add("camera", SystemScheduler::Access{}.write<GameObject>(), [&](const float delta_time) {
+        if (bench) {
+            const CameraPath::Keyframe keyframe = camera_path.sample(path_time);
+            camera.transform.set_position(keyframe.position);
+            camera.transform.set_rotation(keyframe.rotation);
+        } else {
+            camera.update(delta_time);
+        }
+    });
+    systems.add("animation", SystemScheduler::Access{}.write<Transform>(), [&](const float delta_time) {
+        const glm::quat spin = yAxisRotation(45.0f * delta_time);
+        scene.view<Transform>().each([&](Entity, Transform& transform) {
+            transform.set_rotation(glm::normalize(transform.rotation() * spin));
+        });
+    });
+    // After everything that moves scene entities, so the renderer finds their matrices clean
+    systems.add("transforms", SystemScheduler::Access{}.write<Transform>(), [&](float) {
+        scene.view<Transform>().each_block([](std::span<const Entity>, const std::span<Transform> transforms) {
+            transforms::update_matrices(transforms);
+        });
+    });
+    systems.add("streaming", SystemScheduler::Access{}.read<GameObject>().write<ChunkStreamer>(), [&](float) {
+        streamer.update(camera.transform.position());
+    });
+
+    // Longer frames (a stall, a dragged window) are simulated as this long
+    constexpr float kMaxDeltaTime = 0.1f;
+    auto last_frame = std::chrono::steady_clock::now();
+
+    // Benchmarks step simulated time at a fixed rate, so every run renders the same
+    // frames however fast the machine is. The camera first holds at the start of the
+    // path until the chunks around it are loaded and meshed; those frames are not timed.
+    constexpr float kBenchTimeStep = 1.0f / 60.0f;
+    constexpr int kMaxWarmupFrames = 3600;
+    bool warming_up = bench;
+    int warmup_frames = 0;
+    int bench_frames = 0;
+
+    // Recording keeps the camera this often; playback interpolates in between
+    constexpr float kRecordInterval = 0.1f;
+    CameraPath recorded_path;
+    float session_time = 0.0f;
+
+    // Left click removes the block under the crosshair, right click places one against it
+    // and middle click places a lamp
+    constexpr float kPickDistance = 64.0f;
+    bool left_held = false;
+    bool right_held = false;
+    bool middle_held = false;
 
     // Main loop
     while (!glfwWindowShouldClose(window.get())) {
+        const auto now = std::chrono::steady_clock::now();
+        const float delta_time = bench
+            ? kBenchTimeStep
+            : std::min(std::chrono::duration<float>(now - last_frame).count(), kMaxDeltaTime);
+        last_frame = now;
+        const bool timed = profiler && !warming_up;
+        if (timed) {
+            profiler->begin_frame(path_time);
+        }
+        systems.run(delta_time);
+
+        if (!record_path_file.empty()
+            && (recorded_path.empty() || session_time >= recorded_path.duration() + kRecordInterval)) {
+            recorded_path.add({session_time, camera.transform.position(), camera.transform.rotation()});
+        }
+        session_time += delta_time;
+
+        int framebuffer_width, framebuffer_height;
+        if (offscreen) {
+            offscreen->bind();
+            framebuffer_width = offscreen->width();
+            framebuffer_height = offscreen->height();
+        } else {
+            glfwGetFramebufferSize(window.get(), &framebuffer_width, &framebuffer_height);
+        }
+        glViewport(0, 0, framebuffer_width, framebuffer_height);
+
         // Clear the view
         glClearColor(0.6f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        ui::beginFrame();
+        if (!bench) {
+            ui::beginFrame();
+        }
 
         // Setup Projection
-        int framebuffer_width, framebuffer_height;
-        glfwGetFramebufferSize(window.get(), &framebuffer_width, &framebuffer_height);
-        glViewport(0, 0, framebuffer_width, framebuffer_height);
 
-        glMatrixMode(GL_PROJECTION);
         const float aspect_ratio = static_cast<float>(framebuffer_width) / static_cast<float>(framebuffer_height);
         glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspect_ratio, 0.1f, 1000.0f);
-        glLoadMatrixf(glm::value_ptr(projection));
-
-        // Objects
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
 
-        auto camera_rotation = camera.transform.rotation;
-        auto camera_position = camera.transform.position;
+        auto camera_rotation = camera.transform.rotation();
+        auto camera_position = camera.transform.position();
 
         // 1. Create the rotation matrix from the camera's quaternion.
         glm::mat4 camera_rotation_matrix = glm::mat4_cast(camera_rotation);
@@ -295,64 +454,155 @@ int main(int argc, char* argv[]) {
         // 4. Combine translation and rotation.  Order matters!  Translation *then* rotation
         glm::mat4 view_matrix = view_rotation_matrix * view_translation_matrix;
 
-        // 5. Apply the view matrix to the OpenGL MODELVIEW matrix.
-        glMultMatrixf(glm::value_ptr(view_matrix));
+        // Underground, most chunks are sealed off from the camera's cave
+        streamer.update_visibility(camera_position, Frustum::from(projection * view_matrix));
+
+        // Terrain hides most chunks behind it; rasterize its solid cores before drawing
+        if (occlusion_culling) {
+            occlusion.begin_frame(projection * view_matrix);
+            streamer.for_each_occluder([&](const Aabb& occluder) {
+                occlusion.add_occluder(occluder);
+            });
+            occlusion.rasterize(&jobs);
+        }
+        renderer->set_occlusion_culler(occlusion_culling ? &occlusion : nullptr);
+
+        renderer->begin_frame(projection, view_matrix);
 
         // debug::debugViewport();
-        // debug::debugMatrices();
-        debug::drawDebugAxes();
-        debug::drawBoundingBox();
+        // debug::debugMatrices(view_matrix, projection);
+        debug::drawDebugAxes(*renderer);
+        debug::drawBoundingBox(*renderer);
+
+        // The cursor is kept at the center of the window, so the camera looks at the crosshair
+        const glm::vec3 camera_forward = camera_rotation * glm::vec3(0.0f, 0.0f, -1.0f);
+        const auto target = streamer.raycast(camera_position, camera_forward, kPickDistance);
+        if (target) {
+            const glm::vec3 block_min = streamer.config().origin + glm::vec3(target->block);
+            debug::drawBox(*renderer, block_min - 0.01f, block_min + 1.01f, {1.0f, 1.0f, 1.0f, 1.0f});
+        }
 
         // for (auto& cube: cubes) {
-        //     glPushMatrix();
-        //     cube.draw();
-        //     glPopMatrix();
+        //     renderer->submit(cube);
         // }
 
-        for (auto& object: objects) {
-            // How am I going to get this?
-            MeshComponent* mesh = object
-
-            auto position = &object.transform.position;
-            auto rotation = &object.transform.rotation;
-            auto scale = &object.transform.scale;
-            glPushMatrix();
-            glTranslatef(position->x, position->y, position->z);
-            // this->glRotateF();
-            glScalef(scale->x, scale->y, scale->z);
-
-            glBegin(GL_QUADS);
-            for (const auto& vertex : vertices_) {
-                glColor4f(vertex.r, vertex.g, vertex.b, vertex.a);
-                glVertex3f(vertex.x, vertex.y, vertex.z);
+        scene.view<Transform, MeshComponent>().each([&](Entity, const Transform& transform, const MeshComponent& mesh) {
+            renderer->submit(mesh, transform);
+        });
+        streamer.for_each_object([&](const GameObject& object) {
+            renderer->submit(object);
+        });
+
+        renderer->flush();
+        renderer->end_frame();
+
+        if (!bench) {
+            ui::displayTransformOverlay(camera);
+            if (ui::displayMesherOverlay(mesher_backend, streamer.last_mesh_time_us(), streamer.quads())) {
+                mesh_scheduler.set_backend(mesher_backend);
+                streamer.remesh_all();
             }
-            glEnd();
-            glPopMatrix();
-        }
-
-        glBegin(GL_TRIANGLES);
-        glColor3f(1.0f, 1.0f, 1.0f); // White color
-        glVertex3f(0.0f, 100.0f, 1.0f); // Top vertex
-        glVertex3f(100.0f, 100.0f, 10.0f); // Bottom-left vertex
-        glVertex3f(0.0f, 0.0f, 10.0f); // Bottom-right vertex
-        glEnd();
-
-        ui::displayTransformOverlay(camera);
+            ui::displayStreamingOverlay(streamer);
+            ui::displayRendererOverlay(*renderer, occlusion_culling);
+            ui::displaySystemsOverlay(systems);
 
-        ui::render();
+            ui::render();
+        }
 
         debug::check_opengl_errors("Main Loop");
 
+        if (timed) {
+            profiler->end_frame(renderer->draw_calls());
+        }
+
         // vsync
         glfwSwapBuffers(window.get());
         // check for keypress, mouse, window resize, errors
         glfwPollEvents();
 
+        if (bench) {
+            if (warming_up) {
+                const bool loaded = streamer.generating() == 0 && mesh_scheduler.queued() == 0
+                    && mesh_scheduler.in_flight() == 0;
+                warming_up = !loaded && ++warmup_frames < kMaxWarmupFrames;
+            } else if (path_time < camera_path.duration()) {
+                path_time = std::min(static_cast<float>(++bench_frames) * kBenchTimeStep, camera_path.duration());
+            } else {
+                break;
+            }
+            continue;
+        }
+
+        // Between update phases, so the streamer publishes the edits next frame
+        const bool left = glfwGetMouseButton(window.get(), GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+        const bool right = glfwGetMouseButton(window.get(), GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+        const bool middle = glfwGetMouseButton(window.get(), GLFW_MOUSE_BUTTON_MIDDLE) == GLFW_PRESS;
+        if (target && !ImGui::GetIO().WantCaptureMouse) {
+            if (left && !left_held) {
+                streamer.set_block(target->block, kAir);
+            } else if (right && !right_held) {
+                streamer.set_block(target->block + kFaceNormals[static_cast<size_t>(target->face)], kDirt);
+            } else if (middle && !middle_held) {
+                streamer.set_block(target->block + kFaceNormals[static_cast<size_t>(target->face)], kLamp);
+            }
+        }
+        left_held = left;
+        right_held = right;
+        middle_held = middle;
+
         if (!ImGui::GetIO().WantCaptureMouse) {
             center_cursor(window.get());
         }
     }
 
+    if (profiler) {
+        profiler->finish();
+        const std::pair<std::string, std::string> info[] = {
+            {"renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER))},
+            {"gl_version", reinterpret_cast<const char*>(glGetString(GL_VERSION))},
+            {"resolution", std::to_string(offscreen->width()) + "x" + std::to_string(offscreen->height())},
+            {"camera_path", camera_path_file.empty() ? "flyover" : camera_path_file},
+            {"seed", std::to_string(terrain_config.seed)},
+            {"warmup_frames", std::to_string(warmup_frames)},
+        };
+        try {
+            profiler->write_json(bench_output + ".json", info);
+            profiler->write_csv(bench_output + ".csv");
+        } catch (const std::runtime_error& error) {
+            std::cerr << error.what() << std::endl;
+        }
+
+        std::vector<double> cpu;
+        std::vector<double> gpu;
+        for (const FrameProfiler::Frame& frame: profiler->frames()) {
+            cpu.push_back(frame.cpu_ms);
+            if (frame.gpu_ms >= 0.0) {
+                gpu.push_back(frame.gpu_ms);
+            }
+        }
+        const auto print = [](const char* name, const FrameProfiler::Summary& summary) {
+            std::cout << name << " ms: mean " << summary.mean << ", p50 " << summary.p50 << ", p95 " << summary.p95
+                      << ", p99 " << summary.p99 << ", max " << summary.max << std::endl;
+        };
+        std::cout << "Benchmark: " << profiler->frames().size() << " frames after " << warmup_frames
+                  << " warm-up frames, written to " << bench_output << ".json and .csv" << std::endl;
+        print("CPU", FrameProfiler::summarize(cpu));
+        print("GPU", FrameProfiler::summarize(gpu));
+    }
+    if (!record_path_file.empty()) {
+        try {
+            recorded_path.save(record_path_file);
+            std::cout << "Camera path of " << recorded_path.duration() << " s saved to " << record_path_file << std::endl;
+        } catch (const std::runtime_error& error) {
+            std::cerr << error.what() << std::endl;
+        }
+    }
+
+    // GPU resources must be released while the context is still alive
+    profiler.reset();
+    offscreen.reset();
+    renderer.reset();
+
     ui::shutdownImGui();
 
     // Cleanup
@@ -0,0 +1,267 @@
+#ifndef BINARY_MESHER_H
+#define BINARY_MESHER_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Chunk.h"
+#include "ChunkMeshBuilder.h"
+#include "GreedyMesher.h"
+#include "Light.h"
+#include "MeshRegistry.h"
+
+namespace meshing {
+
+// Bitmask mesher. Every row of blocks along each axis is stored as a 64-bit
+// occupancy column (bit i + 1 is the block at coordinate i, bits 0 and Size + 1
+// are the neighbours), so the visible faces of a whole row come out of a couple
+// of shifts and ANDs. Visible faces are scattered into per-material 2D bit planes
+// and merged greedily with count-trailing-zeros scans, without ever touching
+// individual empty blocks.
+//
+// Produces the same quads as greedy_mesh, except that faces between two
+// *different* transparent materials are culled. Baked light and ambient occlusion
+// work the same way: faces are grouped by material, light level and AO level, so
+// only equally shaded faces merge, and faces with uneven AO are emitted directly.
+// The instance keeps its scratch buffers between calls, so reuse one per thread.
+template<int Size>
+class BinaryMesher {
+public:
+    static_assert(Size + 2 <= 64, "A padded column must fit in 64 bits");
+
+    template<typename ChunkT, typename LightT = NoLight>
+    void mesh(const ChunkT& chunk, ChunkMeshBuilder& builder, const LightT& light = {}) {
+        static_assert(ChunkT::kSize == Size);
+        build_columns(chunk);
+        build_face_planes(chunk, light, builder);
+        merge_planes(builder);
+    }
+
+    template<typename ChunkT, typename LightT = NoLight>
+    MeshHandle mesh(const ChunkT& chunk, const LightT& light = {}) {
+        ChunkMeshBuilder builder;
+        mesh(chunk, builder, light);
+        return builder.build();
+    }
+
+private:
+    static constexpr int kPadded = Size + 2;
+    static constexpr std::uint64_t kInteriorBits = ((std::uint64_t{1} << Size) - 1) << 1;
+
+    using Row = std::uint64_t;
+    // One 2D bit plane per slice: rows along v, bits along u
+    using Planes = std::array<Row, Size * Size>;
+
+    struct MaterialFaces {
+        BlockId block;
+        light::Level light;
+        // Level of all four corners
+        int ao;
+        std::array<Planes, 6> faces;
+        bool used[6];
+    };
+
+    static constexpr size_t column(const int a, const int u, const int v) {
+        return (static_cast<size_t>(a) * kPadded + u) * kPadded + v;
+    }
+
+    // Occupancy columns for all three axes, padding included. Solid is opaque | transparent.
+    template<typename ChunkT>
+    void build_columns(const ChunkT& chunk) {
+        opaque_.fill(0);
+        transparent_.fill(0);
+        for (int y = 0; y < Size; y++) {
+            for (int z = 0; z < Size; z++) {
+                // The x column of this row is accumulated in registers and stored once
+                Row opaque_x = 0;
+                Row transparent_x = 0;
+                for (int x = 0; x < Size; x++) {
+                    const BlockId block = chunk.get(x, y, z);
+                    // Branch-free so random cave layouts do not cost mispredictions
+                    const Row opaque = is_opaque(block) ? 1 : 0;
+                    const Row transparent = block != kAir ? opaque ^ 1 : 0;
+
+                    opaque_x |= opaque << (x + 1);
+                    transparent_x |= transparent << (x + 1);
+
+                    const size_t cy = column(1, z + 1, x + 1);
+                    opaque_[cy] |= opaque << (y + 1);
+                    transparent_[cy] |= transparent << (y + 1);
+
+                    const size_t cz = column(2, x + 1, y + 1);
+                    opaque_[cz] |= opaque << (z + 1);
+                    transparent_[cz] |= transparent << (z + 1);
+                }
+                const size_t cx = column(0, y + 1, z + 1);
+                opaque_[cx] = opaque_x;
+                transparent_[cx] = transparent_x;
+            }
+        }
+        // Without padding the neighbours are air and their bits stay clear
+        if constexpr (ChunkT::kPadding > 0) {
+            add_padding_bits(chunk);
+        }
+    }
+
+    // Sets the bits of every padding block in all three columns through it: the
+    // ends of the interior columns, which cull faces, and the columns along the
+    // chunk's edges, which only ambient occlusion reads.
+    template<typename ChunkT>
+    void add_padding_bits(const ChunkT& chunk) {
+        for (int y = -1; y <= Size; y++) {
+            for (int z = -1; z <= Size; z++) {
+                // Rows through the interior only have padding at their ends
+                const int step = y >= 0 && y < Size && z >= 0 && z < Size ? Size + 1 : 1;
+                for (int x = -1; x <= Size; x += step) {
+                    const BlockId block = chunk.get(x, y, z);
+                    if (block == kAir) {
+                        continue;
+                    }
+                    auto& bits = is_opaque(block) ? opaque_ : transparent_;
+                    bits[column(0, y + 1, z + 1)] |= Row{1} << (x + 1);
+                    bits[column(1, z + 1, x + 1)] |= Row{1} << (y + 1);
+                    bits[column(2, x + 1, y + 1)] |= Row{1} << (z + 1);
+                }
+            }
+        }
+    }
+
+    // face_ao() of a face on axis `a` looking into the block at coordinate `k` of
+    // column (u, v), read from the opaque bits of the neighbouring columns.
+    std::uint8_t column_ao(const int a, const int k, const int u, const int v) const {
+        return pack_face_ao([&](const int du, const int dv) {
+            return static_cast<int>(opaque_[column(a, u + 1 + du, v + 1 + dv)] >> (k + 1) & 1);
+        });
+    }
+
+    // Visible faces per column, scattered into per-material planes.
+    template<typename ChunkT, typename LightT>
+    void build_face_planes(const ChunkT& chunk, const LightT& light, ChunkMeshBuilder& builder) {
+        for (auto& material : materials_) {
+            std::fill(std::begin(material.used), std::end(material.used), false);
+        }
+        material_count_ = 0;
+
+        for (int a = 0; a < 3; a++) {
+            for (int v = 1; v <= Size; v++) {
+                for (int u = 1; u <= Size; u++) {
+                    const size_t c = column(a, u, v);
+                    const Row opaque = opaque_[c];
+                    const Row transparent = transparent_[c];
+                    const Row solid = opaque | transparent;
+                    if ((solid & kInteriorBits) == 0) {
+                        continue;
+                    }
+                    // A face shows when the next block along the axis is not opaque, and
+                    // is not the same kind of transparent block
+                    const Row positive = solid & ~(opaque >> 1) & ~(transparent & (transparent >> 1));
+                    const Row negative = solid & ~(opaque << 1) & ~(transparent & (transparent << 1));
+                    scatter(chunk, light, builder, a, true, u - 1, v - 1, (positive & kInteriorBits) >> 1);
+                    scatter(chunk, light, builder, a, false, u - 1, v - 1, (negative & kInteriorBits) >> 1);
+                }
+            }
+        }
+    }
+
+    template<typename ChunkT, typename LightT>
+    void scatter(const ChunkT& chunk, const LightT& light, ChunkMeshBuilder& builder, const int a, const bool positive,
+                 const int u, const int v, Row faces) {
+        const Face face = ChunkMeshBuilder::face_of(a, positive);
+        const int f = static_cast<int>(face);
+        while (faces != 0) {
+            const int k = std::countr_zero(faces);
+            faces &= faces - 1;
+
+            int p[3];
+            p[a] = k;
+            p[(a + 1) % 3] = u;
+            p[(a + 2) % 3] = v;
+            const glm::ivec3 origin(p[0], p[1], p[2]);
+            const BlockId block = chunk.get(origin);
+            // Lit and occluded by the blocks in and around the one in front of the face
+            p[a] += positive ? 1 : -1;
+            const light::Level level = light.get(p[0], p[1], p[2]);
+            const std::uint8_t ao = column_ao(a, p[a], u, v);
+            const int uniform = uniform_ao(ao);
+            if (uniform < 0) {
+                builder.add_quad(face, origin, 1, 1, block, level, ao);
+                continue;
+            }
+            MaterialFaces& material = material_for(block, level, uniform);
+            if (!material.used[f]) {
+                material.faces[f].fill(0);
+                material.used[f] = true;
+            }
+            material.faces[f][static_cast<size_t>(k) * Size + v] |= Row{1} << u;
+        }
+    }
+
+    MaterialFaces& material_for(const BlockId block, const light::Level light, const int ao) {
+        for (size_t i = 0; i < material_count_; i++) {
+            if (materials_[i].block == block && materials_[i].light == light && materials_[i].ao == ao) {
+                return materials_[i];
+            }
+        }
+        if (material_count_ == materials_.size()) {
+            materials_.emplace_back();
+        }
+        MaterialFaces& material = materials_[material_count_++];
+        material.block = block;
+        material.light = light;
+        material.ao = ao;
+        std::fill(std::begin(material.used), std::end(material.used), false);
+        return material;
+    }
+
+    // Greedy rectangle merge on each bit plane using trailing-zero scans.
+    void merge_planes(ChunkMeshBuilder& builder) {
+        for (size_t m = 0; m < material_count_; m++) {
+            MaterialFaces& material = materials_[m];
+            for (int f = 0; f < 6; f++) {
+                if (!material.used[f]) {
+                    continue;
+                }
+                const Face face = static_cast<Face>(f);
+                const int a = ChunkMeshBuilder::axis(face);
+                for (int k = 0; k < Size; k++) {
+                    Row* plane = &material.faces[f][static_cast<size_t>(k) * Size];
+                    for (int v = 0; v < Size; v++) {
+                        while (plane[v] != 0) {
+                            const int u = std::countr_zero(plane[v]);
+                            const int width = std::countr_one(plane[v] >> u);
+                            const Row run = (width == 64 ? ~Row{0} : (Row{1} << width) - 1) << u;
+                            plane[v] &= ~run;
+
+                            int height = 1;
+                            while (v + height < Size && (plane[v + height] & run) == run) {
+                                plane[v + height] &= ~run;
+                                height++;
+                            }
+
+                            glm::ivec3 origin{0};
+                            origin[a] = k;
+                            origin[(a + 1) % 3] = u;
+                            origin[(a + 2) % 3] = v;
+                            builder.add_quad(face, origin, width, height, material.block, material.light,
+                                             static_cast<std::uint8_t>(material.ao * 0x55));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::array<Row, 3 * kPadded * kPadded> opaque_{};
+    std::array<Row, 3 * kPadded * kPadded> transparent_{};
+    std::vector<MaterialFaces> materials_;
+    size_t material_count_{0};
+};
+
+}
+
+#endif //BINARY_MESHER_H
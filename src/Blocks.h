@@ -0,0 +1,46 @@
+#ifndef BLOCKS_H
+#define BLOCKS_H
+
+#include <array>
+#include <cstdint>
+
+#include "Color.h"
+
+using BlockId = std::uint16_t;
+
+static constexpr BlockId kAir = 0;
+static constexpr BlockId kStone = 1;
+static constexpr BlockId kDirt = 2;
+static constexpr BlockId kGrass = 3;
+static constexpr BlockId kSand = 4;
+static constexpr BlockId kWater = 5;
+static constexpr BlockId kSnow = 6;
+static constexpr BlockId kLamp = 7;
+
+static constexpr std::array<Color, 8> kBlockColors = {{
+    {0.0f, 0.0f, 0.0f, 0.0f},   // Air
+    {0.5f, 0.5f, 0.52f, 1.0f},  // Stone
+    {0.45f, 0.3f, 0.2f, 1.0f},  // Dirt
+    {0.3f, 0.6f, 0.25f, 1.0f},  // Grass
+    {0.85f, 0.8f, 0.55f, 1.0f}, // Sand
+    {0.2f, 0.35f, 0.8f, 1.0f},  // Water
+    {0.95f, 0.95f, 0.98f, 1.0f}, // Snow
+    {1.0f, 0.85f, 0.45f, 1.0f}   // Lamp
+}};
+
+// Unknown ids are drawn magenta so they stand out.
+inline Color block_color(const BlockId block) {
+    return block < kBlockColors.size() ? kBlockColors[block] : Color{1.0f, 0.0f, 1.0f, 1.0f};
+}
+
+// Opaque blocks hide the faces of their neighbours.
+inline bool is_opaque(const BlockId block) {
+    return block != kAir && block != kWater;
+}
+
+// Block light a block gives off, 0 to 15.
+inline int block_emission(const BlockId block) {
+    return block == kLamp ? 15 : 0;
+}
+
+#endif //BLOCKS_H
@@ -0,0 +1,55 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+#include "glm/glm.hpp"
+
+struct Sphere {
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+};
+
+// Axis-aligned bounding box. An empty box has min > max.
+struct Aabb {
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+
+    static Aabb of(const std::span<const glm::vec3> points) {
+        if (points.empty()) {
+            return {glm::vec3(0.0f), glm::vec3(0.0f)};
+        }
+        Aabb box{points.front(), points.front()};
+        for (const glm::vec3& point: points) {
+            box.min = glm::min(box.min, point);
+            box.max = glm::max(box.max, point);
+        }
+        return box;
+    }
+
+    [[nodiscard]]
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+
+    [[nodiscard]]
+    glm::vec3 extents() const { return (max - min) * 0.5f; }
+
+    [[nodiscard]]
+    Sphere bounding_sphere() const { return {center(), glm::length(extents())}; }
+
+    // Box enclosing this box after an affine transform (Arvo): the new extents are the
+    // old ones through the absolute value of the linear part.
+    [[nodiscard]]
+    Aabb transformed(const glm::mat4& matrix) const {
+        const glm::vec3 new_center = glm::vec3(matrix * glm::vec4(center(), 1.0f));
+        const glm::vec3 old_extents = extents();
+        glm::vec3 new_extents(0.0f);
+        for (int column = 0; column < 3; column++) {
+            new_extents += glm::abs(glm::vec3(matrix[column])) * old_extents[column];
+        }
+        return {new_center - new_extents, new_center + new_extents};
+    }
+};
+
+#endif //BOUNDS_H
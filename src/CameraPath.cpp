@@ -0,0 +1,118 @@
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+// Velocity through keyframe `i`, from its neighbours; one-sided at the ends
+glm::vec3 tangent(const std::vector<CameraPath::Keyframe>& keyframes, const size_t i) {
+    const CameraPath::Keyframe& before = keyframes[i > 0 ? i - 1 : i];
+    const CameraPath::Keyframe& after = keyframes[std::min(i + 1, keyframes.size() - 1)];
+    const float span = after.time - before.time;
+    return span > 0.0f ? (after.position - before.position) / span : glm::vec3(0.0f);
+}
+
+// Looking down -z when both are 0; positive yaw turns left, positive pitch looks up
+glm::quat heading(const float yaw_degrees, const float pitch_degrees) {
+    return glm::angleAxis(glm::radians(yaw_degrees), glm::vec3(0.0f, 1.0f, 0.0f))
+        * glm::angleAxis(glm::radians(pitch_degrees), glm::vec3(1.0f, 0.0f, 0.0f));
+}
+}
+
+void CameraPath::add(const Keyframe& keyframe) {
+    if (!keyframes_.empty() && keyframe.time <= keyframes_.back().time) {
+        throw std::runtime_error("Camera path keyframe at " + std::to_string(keyframe.time)
+                                 + " is not after the previous one");
+    }
+    keyframes_.push_back(keyframe);
+}
+
+CameraPath::Keyframe CameraPath::sample(const float time) const {
+    if (time <= keyframes_.front().time) {
+        return keyframes_.front();
+    }
+    if (time >= keyframes_.back().time) {
+        return keyframes_.back();
+    }
+    const auto next = std::ranges::upper_bound(keyframes_, time, {}, &Keyframe::time);
+    const auto i = static_cast<size_t>(next - keyframes_.begin()) - 1;
+    const Keyframe& a = keyframes_[i];
+    const Keyframe& b = keyframes_[i + 1];
+    const float duration = b.time - a.time;
+    const float t = (time - a.time) / duration;
+
+    // Cubic Hermite with the tangents scaled to this segment's duration
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    const glm::vec3 position = (2.0f * t3 - 3.0f * t2 + 1.0f) * a.position
+        + (t3 - 2.0f * t2 + t) * duration * tangent(keyframes_, i)
+        + (-2.0f * t3 + 3.0f * t2) * b.position
+        + (t3 - t2) * duration * tangent(keyframes_, i + 1);
+    return {time, position, glm::normalize(glm::slerp(a.rotation, b.rotation, t))};
+}
+
+CameraPath CameraPath::load(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open camera path " + path.string());
+    }
+    CameraPath result;
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++) {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line);
+        Keyframe keyframe;
+        glm::quat& q = keyframe.rotation;
+        if (!(fields >> keyframe.time >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+                     >> q.w >> q.x >> q.y >> q.z)) {
+            throw std::runtime_error("Malformed keyframe on line " + std::to_string(number) + " of " + path.string());
+        }
+        keyframe.rotation = glm::normalize(q);
+        result.add(keyframe);
+    }
+    return result;
+}
+
+void CameraPath::save(const std::filesystem::path& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Failed to create camera path " + path.string());
+    }
+    // Enough digits that a saved path loads back exactly
+    out << std::setprecision(9) << "# time x y z qw qx qy qz" << std::endl;
+    for (const Keyframe& keyframe: keyframes_) {
+        const glm::quat& q = keyframe.rotation;
+        out << keyframe.time << ' ' << keyframe.position.x << ' ' << keyframe.position.y << ' '
+            << keyframe.position.z << ' ' << q.w << ' ' << q.x << ' ' << q.y << ' ' << q.z << '\n';
+    }
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write camera path " + path.string());
+    }
+}
+
+CameraPath CameraPath::flyover() {
+    CameraPath path;
+    // Straight out over the hills, just above the highest peaks
+    path.add({0.0f, {0.0f, 0.0f, 0.0f}, heading(0.0f, -20.0f)});
+    path.add({10.0f, {0.0f, -5.0f, -400.0f}, heading(0.0f, -15.0f)});
+    // A half circle to the left, which brings a whole new view into the frustum
+    path.add({12.0f, {-40.0f, -5.0f, -440.0f}, heading(90.0f, -15.0f)});
+    path.add({14.0f, {-80.0f, -5.0f, -400.0f}, heading(180.0f, -15.0f)});
+    // Down between the hills, where the terrain hides most of the world
+    path.add({20.0f, {-80.0f, -45.0f, -200.0f}, heading(180.0f, -10.0f)});
+    path.add({26.0f, {-80.0f, -45.0f, 0.0f}, heading(180.0f, 0.0f)});
+    // Up and all the way around, with the whole view radius in sight
+    path.add({32.0f, {-80.0f, 40.0f, 60.0f}, heading(180.0f, -35.0f)});
+    path.add({34.0f, {-80.0f, 40.0f, 60.0f}, heading(270.0f, -35.0f)});
+    path.add({36.0f, {-80.0f, 40.0f, 60.0f}, heading(360.0f, -35.0f)});
+    path.add({38.0f, {-80.0f, 40.0f, 60.0f}, heading(450.0f, -35.0f)});
+    path.add({40.0f, {-80.0f, 40.0f, 60.0f}, heading(540.0f, -35.0f)});
+    return path;
+}
@@ -0,0 +1,55 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <filesystem>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+// A camera flight as timed keyframes, replayed by sampling it at any time:
+// positions follow a Catmull-Rom spline through the keyframes and rotations are
+// slerped, so a path recorded a few times per second still plays back smoothly.
+//
+// Saved as text, one keyframe per line: "time x y z qw qx qy qz", with '#'
+// starting a comment. Keyframe times must increase.
+class CameraPath {
+public:
+    struct Keyframe {
+        float time{0.0f};
+        glm::vec3 position{0.0f};
+        glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    };
+
+    // Appends a keyframe. Throws std::runtime_error unless it is later than the last one.
+    void add(const Keyframe& keyframe);
+
+    // The camera at `time`, clamped to the ends of the path. The path must not be empty.
+    [[nodiscard]]
+    Keyframe sample(float time) const;
+
+    // Time of the last keyframe.
+    [[nodiscard]]
+    float duration() const { return keyframes_.empty() ? 0.0f : keyframes_.back().time; }
+
+    [[nodiscard]]
+    bool empty() const { return keyframes_.empty(); }
+
+    [[nodiscard]]
+    const std::vector<Keyframe>& keyframes() const { return keyframes_; }
+
+    // Throws std::runtime_error if the file cannot be read or a line is malformed.
+    static CameraPath load(const std::filesystem::path& path);
+    // Throws std::runtime_error if the file cannot be written.
+    void save(const std::filesystem::path& path) const;
+
+    // A scripted flight over the generated terrain of chunk_preview, starting at
+    // the camera's initial position: a straight pass over the hills, a turn back,
+    // a dive into the valleys and a climb into a full turn overlooking everything.
+    static CameraPath flyover();
+
+private:
+    std::vector<Keyframe> keyframes_;
+};
+
+#endif //CAMERA_PATH_H
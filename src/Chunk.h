@@ -0,0 +1,271 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+
+// Chunk coordinates, in units of whole chunks.
+using ChunkPos = glm::ivec3;
+
+struct ChunkPosHash {
+    size_t operator()(const ChunkPos& position) const {
+        // Large primes spread neighbouring chunks over distinct buckets
+        const auto x = static_cast<std::uint64_t>(static_cast<std::uint32_t>(position.x));
+        const auto y = static_cast<std::uint64_t>(static_cast<std::uint32_t>(position.y));
+        const auto z = static_cast<std::uint64_t>(static_cast<std::uint32_t>(position.z));
+        return static_cast<size_t>(x * 73856093u ^ y * 19349663u ^ z * 83492791u);
+    }
+};
+
+enum class Face : std::uint8_t {
+    NegX, PosX, NegY, PosY, NegZ, PosZ
+};
+
+static constexpr std::array<glm::ivec3, 6> kFaceNormals = {{
+    {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+}};
+
+// Index order: x fastest, then z, then y. Rows along x are contiguous, which is
+// what column-wise loops (meshing, generation) want to vectorize.
+struct YMajorLayout {
+    template<int Dim>
+    static constexpr size_t index(const int x, const int y, const int z) {
+        return (static_cast<size_t>(y) * Dim + static_cast<size_t>(z)) * Dim + static_cast<size_t>(x);
+    }
+
+    template<int Dim>
+    static constexpr size_t volume() {
+        return static_cast<size_t>(Dim) * Dim * Dim;
+    }
+};
+
+// Z-order curve: bits of x, y and z are interleaved so blocks that are close in
+// space are close in memory along every axis, which helps random neighbour access.
+// The storage is rounded up to the next power of two per axis.
+struct MortonLayout {
+    static constexpr std::uint32_t spread_bits(std::uint32_t v) {
+        v = (v | (v << 16)) & 0x030000FFu;
+        v = (v | (v << 8)) & 0x0300F00Fu;
+        v = (v | (v << 4)) & 0x030C30C3u;
+        v = (v | (v << 2)) & 0x09249249u;
+        return v;
+    }
+
+    template<int Dim>
+    static constexpr size_t index(const int x, const int y, const int z) {
+        static_assert(Dim <= 1024, "Morton layout supports at most 10 bits per axis");
+        return spread_bits(static_cast<std::uint32_t>(x))
+            | (spread_bits(static_cast<std::uint32_t>(z)) << 1)
+            | (spread_bits(static_cast<std::uint32_t>(y)) << 2);
+    }
+
+    template<int Dim>
+    static constexpr size_t volume() {
+        const size_t rounded = std::bit_ceil(static_cast<size_t>(Dim));
+        return rounded * rounded * rounded;
+    }
+};
+
+// Dense cube of Size^3 blocks stored in a single aligned array.
+//
+// Padding adds a border of that many blocks on every side, addressable with
+// coordinates in [-Padding, Size + Padding). Meshers fill it with copies of the
+// neighbouring chunks' edge blocks so that face culling never has to look outside
+// this chunk.
+template<int Size, typename BlockT = BlockId, typename Layout = YMajorLayout, int Padding = 0>
+class Chunk {
+public:
+    static_assert(Size > 0 && Padding >= 0);
+
+    using Block = BlockT;
+    using LayoutType = Layout;
+
+    static constexpr int kSize = Size;
+    static constexpr int kPadding = Padding;
+    // Blocks per axis including the padding on both sides
+    static constexpr int kStride = Size + 2 * Padding;
+    static constexpr size_t kVolume = static_cast<size_t>(Size) * Size * Size;
+    static constexpr size_t kStorageVolume = Layout::template volume<kStride>();
+
+    Chunk() { blocks_.fill(BlockT{}); }
+
+    explicit Chunk(const BlockT fill_value) { blocks_.fill(fill_value); }
+
+    // Storage index of a block; coordinates may address the padding.
+    static constexpr size_t index(const int x, const int y, const int z) {
+        return Layout::template index<kStride>(x + Padding, y + Padding, z + Padding);
+    }
+
+    static constexpr bool contains(const int x, const int y, const int z) {
+        return x >= 0 && y >= 0 && z >= 0 && x < Size && y < Size && z < Size;
+    }
+
+    static constexpr bool contains_padded(const int x, const int y, const int z) {
+        return x >= -Padding && y >= -Padding && z >= -Padding
+            && x < Size + Padding && y < Size + Padding && z < Size + Padding;
+    }
+
+    [[nodiscard]]
+    BlockT get(const int x, const int y, const int z) const { return blocks_[index(x, y, z)]; }
+
+    [[nodiscard]]
+    BlockT get(const glm::ivec3& p) const { return get(p.x, p.y, p.z); }
+
+    void set(const int x, const int y, const int z, const BlockT block) { blocks_[index(x, y, z)] = block; }
+
+    void set(const glm::ivec3& p, const BlockT block) { set(p.x, p.y, p.z, block); }
+
+    void fill(const BlockT block) { blocks_.fill(block); }
+
+    // Calls fn(x, y, z, block) for every interior block, in an order that walks
+    // memory linearly for the Y-major layout.
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        for (int y = 0; y < Size; y++) {
+            for (int z = 0; z < Size; z++) {
+                for (int x = 0; x < Size; x++) {
+                    fn(x, y, z, get(x, y, z));
+                }
+            }
+        }
+    }
+
+    // Contiguous x row at (y, z), including padding. Only meaningful for the
+    // Y-major layout, where rows are contiguous in memory.
+    [[nodiscard]]
+    std::span<const BlockT, kStride> row(const int y, const int z) const requires std::is_same_v<Layout, YMajorLayout> {
+        return std::span<const BlockT, kStride>(&blocks_[index(-Padding, y, z)], kStride);
+    }
+
+    [[nodiscard]]
+    std::span<BlockT, kStride> row(const int y, const int z) requires std::is_same_v<Layout, YMajorLayout> {
+        return std::span<BlockT, kStride>(&blocks_[index(-Padding, y, z)], kStride);
+    }
+
+    // Number of non-air blocks, counted over raw storage so the loop vectorizes.
+    // Padding and layout slack are included when they hold non-air values.
+    [[nodiscard]]
+    size_t count_solid() const {
+        size_t count = 0;
+        for (size_t i = 0; i < kStorageVolume; i++) {
+            count += blocks_[i] != BlockT{} ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Copies the edge layer of `neighbor` that touches `face` of this chunk into
+    // this chunk's padding.
+    template<typename Neighbor>
+    void copy_padding_from(const Neighbor& neighbor, const Face face) requires (Padding > 0) {
+        const glm::ivec3 normal = kFaceNormals[static_cast<size_t>(face)];
+        const int axis = normal.x != 0 ? 0 : normal.y != 0 ? 1 : 2;
+        const int sign = normal[axis];
+        // The two axes orthogonal to the face
+        const int u_axis = axis == 0 ? 1 : 0;
+        const int v_axis = axis == 2 ? 1 : 2;
+        for (int layer = 0; layer < Padding; layer++) {
+            for (int v = 0; v < Size; v++) {
+                for (int u = 0; u < Size; u++) {
+                    glm::ivec3 dst{};
+                    glm::ivec3 src{};
+                    // Padding layer on this chunk and the matching edge layer of the neighbour
+                    dst[axis] = sign > 0 ? Size + layer : -1 - layer;
+                    src[axis] = sign > 0 ? layer : Size - 1 - layer;
+                    dst[u_axis] = src[u_axis] = u;
+                    dst[v_axis] = src[v_axis] = v;
+                    set(dst, neighbor.get(src));
+                }
+            }
+        }
+    }
+
+    // Sets the padding on `face` to a constant, e.g. air at the edge of the world.
+    void fill_padding(const Face face, const BlockT block) requires (Padding > 0) {
+        const glm::ivec3 normal = kFaceNormals[static_cast<size_t>(face)];
+        const int axis = normal.x != 0 ? 0 : normal.y != 0 ? 1 : 2;
+        const int sign = normal[axis];
+        const int u_axis = axis == 0 ? 1 : 0;
+        const int v_axis = axis == 2 ? 1 : 2;
+        for (int layer = 0; layer < Padding; layer++) {
+            for (int v = 0; v < Size; v++) {
+                for (int u = 0; u < Size; u++) {
+                    glm::ivec3 p{};
+                    p[axis] = sign > 0 ? Size + layer : -1 - layer;
+                    p[u_axis] = u;
+                    p[v_axis] = v;
+                    set(p, block);
+                }
+            }
+        }
+    }
+
+    // Copies the interior of `source`, a chunk of the same size, leaving the padding as it is.
+    template<typename Source>
+    void copy_interior_from(const Source& source) {
+        static_assert(Source::kSize == Size);
+        if constexpr (std::is_same_v<Layout, YMajorLayout> && std::is_same_v<typename Source::LayoutType, YMajorLayout>) {
+            for (int y = 0; y < Size; y++) {
+                for (int z = 0; z < Size; z++) {
+                    const auto from = source.row(y, z).template subspan<Source::kPadding, Size>();
+                    std::ranges::copy(from, row(y, z).begin() + Padding);
+                }
+            }
+        } else {
+            source.for_each([this](const int x, const int y, const int z, const BlockT block) { set(x, y, z, block); });
+        }
+    }
+
+    // Fills all of the padding, edges and corners included, from the 26 chunks
+    // around this one. neighbor(offset) returns a pointer to the chunk at `offset`
+    // (each component -1, 0 or 1), or nullptr where the padding should be air.
+    template<typename Lookup>
+    void fill_padding_from(Lookup&& neighbor) requires (Padding > 0 && Padding <= Size) {
+        const auto side = [](const int c) { return c < 0 ? -1 : c >= Size ? 1 : 0; };
+        for (int y = -Padding; y < Size + Padding; y++) {
+            for (int z = -Padding; z < Size + Padding; z++) {
+                // The row crosses up to three neighbours along x
+                for (int sx = -1; sx <= 1; sx++) {
+                    const glm::ivec3 offset{sx, side(y), side(z)};
+                    if (offset == glm::ivec3(0)) {
+                        continue;
+                    }
+                    const int begin = sx < 0 ? -Padding : sx == 0 ? 0 : Size;
+                    const int end = sx < 0 ? 0 : sx == 0 ? Size : Size + Padding;
+                    const auto* source = neighbor(offset);
+                    for (int x = begin; x < end; x++) {
+                        set(x, y, z, source ? source->get(x - sx * Size, y - offset.y * Size, z - offset.z * Size)
+                                            : BlockT{});
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]]
+    std::span<const BlockT> data() const { return blocks_; }
+
+    [[nodiscard]]
+    std::span<BlockT> data() { return blocks_; }
+
+private:
+    alignas(64) std::array<BlockT, kStorageVolume> blocks_;
+};
+
+// Chunk dimensions used by the previewer.
+static constexpr int kChunkSize = 32;
+
+using DenseChunk = Chunk<kChunkSize>;
+
+// A DenseChunk with a one-block border of its neighbours' blocks, for meshing it
+// with the faces against neighbouring chunks culled.
+using PaddedChunk = Chunk<kChunkSize, BlockId, YMajorLayout, 1>;
+
+#endif //CHUNK_H
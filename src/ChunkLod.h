@@ -0,0 +1,167 @@
+#ifndef CHUNK_LOD_H
+#define CHUNK_LOD_H
+
+#include <algorithm>
+#include <array>
+
+#include "Blocks.h"
+#include "Chunk.h"
+#include "ChunkMeshBuilder.h"
+#include "ChunkMesher.h"
+#include "Light.h"
+
+// Level of detail for distant chunks. At level L a chunk is meshed from a copy
+// downsampled by 2^L per axis (2x, 4x, 8x merged blocks) with the regular meshers,
+// and the quads are scaled back up, so a distant chunk costs roughly 4^L times
+// fewer quads.
+//
+// Seams: every chunk mesh is closed at the chunk border (the meshers treat the
+// outside as air), so neighbours meshed at different levels can overlap or step
+// but never leave a crack to see through. A merged cell is solid when at least
+// half its blocks are, which keeps the coarse surface within half a cell of the
+// full-detail one.
+//
+// Baked light only applies at full detail; coarser levels are drawn as if under
+// open sky, which is what a distant surface mostly is.
+namespace lod {
+constexpr int kMaxLevel = 3;
+constexpr int kLevels = kMaxLevel + 1;
+
+template<int Level>
+using LodChunk = Chunk<(kChunkSize >> Level), BlockId>;
+
+static_assert((kChunkSize >> kMaxLevel) > 0 && kChunkSize % (1 << kMaxLevel) == 0);
+
+// Merges each 2^Level cube of blocks into one. Solid cells take the most common
+// block of the highest layer that has any, which is the material seen from above.
+template<int Level>
+void downsample(const DenseChunk& chunk, LodChunk<Level>& out) {
+    constexpr int kScale = 1 << Level;
+    constexpr int kCellVolume = kScale * kScale * kScale;
+    std::array<BlockId, kScale * kScale> layer{};
+    std::array<BlockId, kScale * kScale> ids{};
+    std::array<int, kScale * kScale> votes{};
+
+    for (int cy = 0; cy < LodChunk<Level>::kSize; cy++) {
+        for (int cz = 0; cz < LodChunk<Level>::kSize; cz++) {
+            for (int cx = 0; cx < LodChunk<Level>::kSize; cx++) {
+                int solid = 0;
+                BlockId surface = kAir;
+                for (int y = kScale - 1; y >= 0; y--) {
+                    size_t count = 0;
+                    for (int z = 0; z < kScale; z++) {
+                        for (int x = 0; x < kScale; x++) {
+                            const BlockId block = chunk.get(cx * kScale + x, cy * kScale + y, cz * kScale + z);
+                            if (block != kAir) {
+                                layer[count++] = block;
+                            }
+                        }
+                    }
+                    solid += static_cast<int>(count);
+                    if (surface == kAir && count > 0) {
+                        // Tally per distinct id; a layer rarely holds more than two or
+                        // three, so this beats sorting it. Ties go to the lowest id
+                        size_t distinct = 0;
+                        for (size_t i = 0; i < count; i++) {
+                            size_t d = 0;
+                            while (d < distinct && ids[d] != layer[i]) {
+                                d++;
+                            }
+                            if (d == distinct) {
+                                ids[distinct] = layer[i];
+                                votes[distinct++] = 0;
+                            }
+                            votes[d]++;
+                        }
+                        size_t best = 0;
+                        for (size_t d = 1; d < distinct; d++) {
+                            if (votes[d] > votes[best] || (votes[d] == votes[best] && ids[d] < ids[best])) {
+                                best = d;
+                            }
+                        }
+                        surface = ids[best];
+                    }
+                }
+                out.set(cx, cy, cz, solid * 2 >= kCellVolume ? surface : kAir);
+            }
+        }
+    }
+}
+
+template<int Level>
+void mesh_level(const DenseChunk& chunk, const meshing::MesherBackend backend, ChunkMeshBuilder& builder) {
+    LodChunk<Level> coarse;
+    downsample<Level>(chunk, coarse);
+    builder.set_scale(1 << Level);
+    meshing::mesh_chunk(coarse, backend, builder);
+    builder.set_scale(1);
+}
+
+// Meshes `chunk` at `level` (clamped to [0, kMaxLevel]) into `builder`, with
+// `light` baked in at level 0 when given.
+inline void mesh_chunk(const DenseChunk& chunk, const int level, const meshing::MesherBackend backend,
+                       ChunkMeshBuilder& builder, const LightVolume* light = nullptr) {
+    switch (std::clamp(level, 0, kMaxLevel)) {
+        case 0:
+            if (light) {
+                meshing::mesh_chunk(chunk, backend, builder, *light);
+            } else {
+                meshing::mesh_chunk(chunk, backend, builder);
+            }
+        break;
+        case 1:
+            mesh_level<1>(chunk, backend, builder);
+        break;
+        case 2:
+            mesh_level<2>(chunk, backend, builder);
+        break;
+        default:
+            mesh_level<3>(chunk, backend, builder);
+        break;
+    }
+}
+
+inline MeshHandle mesh_chunk(const DenseChunk& chunk, const int level, const meshing::MesherBackend backend,
+                             const LightVolume* light = nullptr) {
+    ChunkMeshBuilder builder;
+    mesh_chunk(chunk, level, backend, builder, light);
+    return builder.build();
+}
+
+// Distance, in chunks, from which `level` (> 0) applies: `first_distance` for
+// level 1, doubling with every level after it.
+inline float level_distance(const int level, const float first_distance) {
+    return first_distance * static_cast<float>(1 << (level - 1));
+}
+
+// Level for a chunk `distance` chunks away. A first_distance of 0 disables LOD.
+inline int level_for(const float distance, const float first_distance) {
+    if (first_distance <= 0.0f) {
+        return 0;
+    }
+    int level = 0;
+    while (level < kMaxLevel && distance >= level_distance(level + 1, first_distance)) {
+        level++;
+    }
+    return level;
+}
+
+// Like level_for(), but a chunk at `current` only changes level once it is more
+// than `hysteresis` (a fraction of the threshold) past the boundary, so a camera
+// hovering around a threshold does not remesh the chunks there every frame.
+inline int select_level(const float distance, const int current, const float first_distance, const float hysteresis) {
+    if (first_distance <= 0.0f) {
+        return 0;
+    }
+    int level = std::clamp(current, 0, kMaxLevel);
+    while (level < kMaxLevel && distance >= level_distance(level + 1, first_distance) * (1.0f + hysteresis)) {
+        level++;
+    }
+    while (level > 0 && distance < level_distance(level, first_distance) * (1.0f - hysteresis)) {
+        level--;
+    }
+    return level;
+}
+}
+
+#endif //CHUNK_LOD_H
@@ -0,0 +1,114 @@
+#ifndef CHUNK_MESH_BUILDER_H
+#define CHUNK_MESH_BUILDER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Chunk.h"
+#include "MeshRegistry.h"
+#include "PackedVertex.h"
+
+// Accumulates axis-aligned block faces into mesh geometry. Shared by the chunk
+// meshers so they only decide *which* quads exist, not how they are encoded.
+//
+// Vertices are emitted in the 8-byte PackedVertex format; colors and face shading
+// are applied by the voxel shader from the block id and face.
+class ChunkMeshBuilder {
+public:
+    // Adds a quad covering `width` x `height` block faces. `origin` is the block
+    // (in chunk-local coordinates) at the quad's minimum corner; width runs along
+    // axis (d + 1) % 3 and height along (d + 2) % 3, where d is the face's axis.
+    // `light` is baked into all four corners; `ao` holds the ambient occlusion of
+    // each corner (see corner_ao()).
+    void add_quad(const Face face, const glm::ivec3& block_origin, const int block_width, const int block_height,
+                  const BlockId block, const light::Level light = light::kFullSky, const std::uint8_t ao = kOpenAo) {
+        const glm::ivec3 origin = block_origin * scale_;
+        const int width = block_width * scale_;
+        const int height = block_height * scale_;
+        const int d = axis(face);
+        const int u = (d + 1) % 3;
+        const int v = (d + 2) % 3;
+        const bool positive = is_positive(face);
+
+        glm::ivec3 corner[4] = {origin, origin, origin, origin};
+        if (positive) {
+            for (glm::ivec3& c: corner) {
+                c[d] += scale_;
+            }
+        }
+        corner[1][u] += width;
+        corner[2][u] += width;
+        corner[2][v] += height;
+        corner[3][v] += height;
+
+        const auto first = static_cast<unsigned int>(vertices_.size());
+        for (int i = 0; i < 4; i++) {
+            const glm::ivec3& c = corner[i];
+            vertices_.push_back(PackedVertex::pack(c.x, c.y, c.z, face, corner_ao(ao, i), block, light));
+        }
+        // u x v points along +d, so this order is counter-clockwise seen from outside
+        const unsigned int order[4] = {
+            first, positive ? first + 1 : first + 3, first + 2, positive ? first + 3 : first + 1,
+        };
+        // Split along the brighter diagonal, so a single dark corner darkens only its
+        // own triangle instead of streaking across the quad
+        const int s = corner_ao(ao, 0) + corner_ao(ao, 2) < corner_ao(ao, 1) + corner_ao(ao, 3) ? 1 : 0;
+        indices_.push_back(order[s]);
+        indices_.push_back(order[s + 1]);
+        indices_.push_back(order[s + 2]);
+        indices_.push_back(order[s + 2]);
+        indices_.push_back(order[(s + 3) % 4]);
+        indices_.push_back(order[s]);
+        ++quads_;
+    }
+
+    // Ambient occlusion of every corner left open.
+    static constexpr std::uint8_t kOpenAo = 0xFF;
+
+    // Ambient occlusion of corner `i` in `ao`, from 0 (fully occluded) to 3 (open).
+    // Corners go 2 bits each, lowest first: the quad's origin, then +u, +u +v, +v.
+    static constexpr std::uint32_t corner_ao(const std::uint8_t ao, const int i) {
+        return static_cast<std::uint32_t>(ao) >> (2 * i) & 3u;
+    }
+
+    // Size of one block of the quads that follow, in chunk-local units. Meshers of
+    // downsampled chunks (see ChunkLod.h) set it so their quads cover the full chunk.
+    void set_scale(const int scale) { scale_ = scale; }
+
+    [[nodiscard]]
+    size_t quad_count() const { return quads_; }
+
+    [[nodiscard]]
+    bool empty() const { return quads_ == 0; }
+
+    void clear() {
+        vertices_.clear();
+        indices_.clear();
+        quads_ = 0;
+    }
+
+    // Chunk meshes are unique, so they bypass the registry's deduplication.
+    MeshHandle build() {
+        auto mesh = MeshRegistry::create_packed(std::move(vertices_), std::move(indices_));
+        clear();
+        return mesh;
+    }
+
+    static constexpr int axis(const Face face) { return static_cast<int>(face) / 2; }
+
+    static constexpr bool is_positive(const Face face) { return static_cast<int>(face) % 2 == 1; }
+
+    static constexpr Face face_of(const int axis, const bool positive) {
+        return static_cast<Face>(axis * 2 + (positive ? 1 : 0));
+    }
+
+private:
+    std::vector<PackedVertex> vertices_;
+    std::vector<unsigned int> indices_;
+    size_t quads_{0};
+    int scale_{1};
+};
+
+#endif //CHUNK_MESH_BUILDER_H
@@ -0,0 +1,117 @@
+#include "ChunkMeshScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "glm/geometric.hpp"
+
+ChunkMeshScheduler::ChunkMeshScheduler(JobSystem& jobs, const meshing::MesherBackend backend,
+                                       const size_t jobs_per_worker)
+    : jobs_(jobs),
+      backend_(backend),
+      max_in_flight_(std::max<size_t>(jobs.worker_count() * jobs_per_worker, 1)),
+      completed_(std::make_shared<MpscQueue<Completed>>()) {
+}
+
+void ChunkMeshScheduler::request(const ChunkPos& position, ChunkSnapshot chunk, const int lod,
+                                 const JobSystem::Priority priority, LightSnapshot light, Neighbours neighbours) {
+    const std::uint64_t revision = next_revision_++;
+    latest_[position] = revision;
+    queued_[position] = Request{std::move(chunk), std::move(light), std::move(neighbours), lod, priority, revision};
+}
+
+void ChunkMeshScheduler::cancel(const ChunkPos& position) {
+    queued_.erase(position);
+    latest_.erase(position);
+}
+
+std::vector<ChunkMeshResult> ChunkMeshScheduler::mesh_now(const std::span<const ImmediateRequest> requests) {
+    for (const ImmediateRequest& request: requests) {
+        cancel(request.position);
+    }
+    std::vector<ChunkMeshResult> results(requests.size());
+    jobs_.parallel_for(requests.size(), [&](const size_t i) {
+        const ImmediateRequest& request = requests[i];
+        results[i] = mesh(request.position, *request.chunk, request.neighbours, request.light.get(), request.lod,
+                          backend_);
+    });
+    return results;
+}
+
+ChunkMeshResult ChunkMeshScheduler::mesh(const ChunkPos& position, const DenseChunk& chunk,
+                                         const Neighbours& neighbours, const LightVolume* light, const int lod,
+                                         const meshing::MesherBackend backend) {
+    const auto start = std::chrono::steady_clock::now();
+    MeshHandle mesh;
+    if (lod <= 0) {
+        // Every block is overwritten, so the buffer is reused without clearing
+        thread_local PaddedChunk padded;
+        padded.copy_interior_from(chunk);
+        padded.fill_padding_from([&](const glm::ivec3& offset) { return neighbours[neighbour_index(offset)].get(); });
+        mesh = light ? meshing::mesh_chunk(padded, backend, *light) : meshing::mesh_chunk(padded, backend);
+    } else {
+        mesh = lod::mesh_chunk(chunk, lod, backend);
+    }
+    const double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return {position, std::move(mesh), visibility::compute(chunk), lod, elapsed};
+}
+
+void ChunkMeshScheduler::dispatch(const glm::vec3& camera_position) {
+    if (queued_.empty() || in_flight_ >= max_in_flight_) {
+        return;
+    }
+
+    struct Candidate {
+        ChunkPos position;
+        bool high_priority;
+        float distance_squared;
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(queued_.size());
+    constexpr float half = static_cast<float>(kChunkSize) * 0.5f;
+    for (const auto& [position, request]: queued_) {
+        const glm::vec3 center = glm::vec3(position) * static_cast<float>(kChunkSize) + half;
+        const glm::vec3 offset = center - camera_position;
+        candidates.push_back({position, request.priority == JobSystem::Priority::High, glm::dot(offset, offset)});
+    }
+
+    // Only the chunks that fit in the free slots need to be in order
+    const size_t count = std::min(max_in_flight_ - in_flight_, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(count), candidates.end(),
+                      [](const Candidate& a, const Candidate& b) {
+                          if (a.high_priority != b.high_priority) {
+                              return a.high_priority;
+                          }
+                          return a.distance_squared < b.distance_squared;
+                      });
+
+    for (size_t i = 0; i < count; i++) {
+        auto node = queued_.extract(candidates[i].position);
+        const ChunkPos position = node.key();
+        const JobSystem::Priority priority = node.mapped().priority;
+        Request request = std::move(node.mapped());
+
+        jobs_.submit([completed = completed_, position, request = std::move(request), backend = backend_] {
+            completed->push(Completed{mesh(position, *request.chunk, request.neighbours, request.light.get(),
+                                           request.lod, backend),
+                                      request.revision});
+        }, priority);
+        in_flight_++;
+    }
+}
+
+std::optional<ChunkMeshResult> ChunkMeshScheduler::poll() {
+    while (auto completed = completed_->try_pop()) {
+        in_flight_--;
+        const auto latest = latest_.find(completed->result.position);
+        if (latest == latest_.end() || latest->second != completed->revision) {
+            // Cancelled, or a newer snapshot of this chunk was requested meanwhile
+            continue;
+        }
+        latest_.erase(latest);
+        return std::move(completed->result);
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,141 @@
+#ifndef CHUNK_MESH_SCHEDULER_H
+#define CHUNK_MESH_SCHEDULER_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Chunk.h"
+#include "ChunkLod.h"
+#include "ChunkMesher.h"
+#include "ChunkVisibility.h"
+#include "Light.h"
+#include "JobSystem.h"
+#include "MeshRegistry.h"
+#include "MpscQueue.h"
+
+struct ChunkMeshResult {
+    ChunkPos position;
+    MeshHandle mesh;
+    // Face connectivity of the same snapshot, for cave culling
+    ChunkVisibility visibility;
+    // Level of detail the mesh was built at
+    int lod{0};
+    double mesh_time_us{0.0};
+};
+
+// Meshes chunks on a JobSystem and hands the finished geometry back to the render
+// thread, which uploads it when the mesh is first submitted to the Renderer.
+//
+// Requests are held back until dispatch(), which sends the ones nearest to the
+// camera first and keeps only a few jobs per worker in flight, so ordering follows
+// the camera as it moves instead of being fixed at request time. Finished meshes
+// come back through a lock-free queue; poll() drops results that were superseded
+// by a newer request for the same chunk.
+//
+// Not thread-safe: driven by one thread at a time, normally the render thread.
+class ChunkMeshScheduler {
+public:
+    // Chunks are immutable once handed over; edits publish a new snapshot.
+    using ChunkSnapshot = std::shared_ptr<const DenseChunk>;
+    // Light to bake into a full-detail mesh; null draws it as under open sky.
+    using LightSnapshot = std::shared_ptr<const LightVolume>;
+    // The 26 chunks around a full-detail mesh, by neighbour_index(); null ones count
+    // as air. Their blocks along the shared border cull the faces against them.
+    using Neighbours = std::array<ChunkSnapshot, 27>;
+
+    // Slot of the chunk at `offset` (each component -1, 0 or 1) in Neighbours.
+    static constexpr size_t neighbour_index(const glm::ivec3& offset) {
+        return static_cast<size_t>((offset.y + 1) * 9 + (offset.z + 1) * 3 + offset.x + 1);
+    }
+
+    explicit ChunkMeshScheduler(JobSystem& jobs,
+                                meshing::MesherBackend backend = meshing::MesherBackend::Greedy,
+                                size_t jobs_per_worker = 2);
+
+    ChunkMeshScheduler(const ChunkMeshScheduler&) = delete;
+    ChunkMeshScheduler& operator=(const ChunkMeshScheduler&) = delete;
+
+    // Queues `chunk` for meshing at level of detail `lod` (see ChunkLod.h),
+    // replacing any request for the same position that has not been dispatched yet.
+    // High priority requests skip the distance order. `neighbours` only matter at
+    // level 0; coarser levels mesh the chunk on its own.
+    void request(const ChunkPos& position, ChunkSnapshot chunk, int lod = 0,
+                 JobSystem::Priority priority = JobSystem::Priority::Normal, LightSnapshot light = nullptr,
+                 Neighbours neighbours = {});
+
+    // Drops a queued request and ignores any result still in flight for `position`.
+    void cancel(const ChunkPos& position);
+
+    struct ImmediateRequest {
+        ChunkPos position;
+        ChunkSnapshot chunk;
+        int lod{0};
+        LightSnapshot light;
+        Neighbours neighbours{};
+    };
+
+    // Meshes `requests` right away and returns their results in the same order,
+    // superseding anything queued or in flight for those positions. The calling
+    // thread takes part and the pool helps at high priority, ignoring the in-flight
+    // limit: meant for the few chunks an edit touched, which must not wait behind
+    // background streaming.
+    std::vector<ChunkMeshResult> mesh_now(std::span<const ImmediateRequest> requests);
+
+    // Submits the queued requests closest to `camera_position` (in world units, with
+    // chunk `p` spanning p * kChunkSize to (p + 1) * kChunkSize) while there is room.
+    void dispatch(const glm::vec3& camera_position);
+
+    // Returns the next finished mesh, if any.
+    std::optional<ChunkMeshResult> poll();
+
+    void set_backend(const meshing::MesherBackend backend) { backend_ = backend; }
+
+    [[nodiscard]]
+    meshing::MesherBackend backend() const { return backend_; }
+
+    // Requests waiting for dispatch().
+    [[nodiscard]]
+    size_t queued() const { return queued_.size(); }
+
+    // Jobs submitted whose result has not been returned by poll() yet.
+    [[nodiscard]]
+    size_t in_flight() const { return in_flight_; }
+
+private:
+    struct Request {
+        ChunkSnapshot chunk;
+        LightSnapshot light;
+        Neighbours neighbours;
+        int lod;
+        JobSystem::Priority priority;
+        std::uint64_t revision;
+    };
+
+    struct Completed {
+        ChunkMeshResult result;
+        std::uint64_t revision;
+    };
+
+    static ChunkMeshResult mesh(const ChunkPos& position, const DenseChunk& chunk, const Neighbours& neighbours,
+                                const LightVolume* light, int lod, meshing::MesherBackend backend);
+
+    JobSystem& jobs_;
+    meshing::MesherBackend backend_;
+    size_t max_in_flight_;
+    size_t in_flight_{0};
+    std::uint64_t next_revision_{1};
+
+    std::unordered_map<ChunkPos, Request, ChunkPosHash> queued_;
+    // Revision of the newest request per position; older results are stale
+    std::unordered_map<ChunkPos, std::uint64_t, ChunkPosHash> latest_;
+    // Shared with the jobs so a late job never writes into a destroyed scheduler
+    std::shared_ptr<MpscQueue<Completed>> completed_;
+};
+
+#endif //CHUNK_MESH_SCHEDULER_H
@@ -0,0 +1,49 @@
+#ifndef CHUNK_MESHER_H
+#define CHUNK_MESHER_H
+
+#include <array>
+#include <cstdint>
+
+#include "BinaryMesher.h"
+#include "ChunkMeshBuilder.h"
+#include "GreedyMesher.h"
+#include "Light.h"
+#include "MeshRegistry.h"
+
+namespace meshing {
+
+// Interchangeable mesher implementations, selectable at runtime for A/B comparison.
+enum class MesherBackend : std::uint8_t {
+    Greedy,
+    Binary,
+};
+
+static constexpr std::array<const char*, 2> kMesherBackendNames = {"Greedy", "Binary"};
+
+// `light` bakes per-face light levels (a LightVolume); NoLight draws everything as
+// under open sky.
+template<typename ChunkT, typename LightT = NoLight>
+void mesh_chunk(const ChunkT& chunk, const MesherBackend backend, ChunkMeshBuilder& builder, const LightT& light = {}) {
+    switch (backend) {
+        case MesherBackend::Greedy:
+            greedy_mesh(chunk, builder, light);
+        break;
+        case MesherBackend::Binary: {
+            // Scratch columns and planes are reused across calls on the same thread
+            thread_local BinaryMesher<ChunkT::kSize> mesher;
+            mesher.mesh(chunk, builder, light);
+        }
+        break;
+    }
+}
+
+template<typename ChunkT, typename LightT = NoLight>
+MeshHandle mesh_chunk(const ChunkT& chunk, const MesherBackend backend, const LightT& light = {}) {
+    ChunkMeshBuilder builder;
+    mesh_chunk(chunk, backend, builder, light);
+    return builder.build();
+}
+
+}
+
+#endif //CHUNK_MESHER_H
@@ -0,0 +1,49 @@
+#ifndef CHUNK_OCCLUDERS_H
+#define CHUNK_OCCLUDERS_H
+
+#include <algorithm>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Bounds.h"
+#include "Chunk.h"
+
+namespace occlusion {
+
+// Conservative occluder boxes for a chunk: the chunk is split into groups of
+// `group` x `group` columns, and each group contributes the box from the chunk's
+// floor up to the lowest point where any of its columns stops being opaque. Every
+// box is therefore entirely solid, which is what OcclusionCuller requires.
+//
+// `origin` is the world position of block (0, 0, 0).
+template<typename ChunkT>
+std::vector<Aabb> chunk_occluders(const ChunkT& chunk, const glm::vec3& origin, const int group = 16) {
+    std::vector<Aabb> occluders;
+    for (int group_z = 0; group_z < ChunkT::kSize; group_z += group) {
+        for (int group_x = 0; group_x < ChunkT::kSize; group_x += group) {
+            int height = ChunkT::kSize;
+            for (int z = group_z; z < std::min(group_z + group, ChunkT::kSize) && height > 0; z++) {
+                for (int x = group_x; x < std::min(group_x + group, ChunkT::kSize) && height > 0; x++) {
+                    int solid = 0;
+                    while (solid < height && is_opaque(chunk.get(x, solid, z))) {
+                        solid++;
+                    }
+                    height = solid;
+                }
+            }
+            if (height > 0) {
+                const glm::vec3 low = origin + glm::vec3(static_cast<float>(group_x), 0.0f, static_cast<float>(group_z));
+                const glm::vec3 size(static_cast<float>(std::min(group, ChunkT::kSize - group_x)),
+                                     static_cast<float>(height),
+                                     static_cast<float>(std::min(group, ChunkT::kSize - group_z)));
+                occluders.push_back({low, low + size});
+            }
+        }
+    }
+    return occluders;
+}
+
+}
+
+#endif //CHUNK_OCCLUDERS_H
@@ -0,0 +1,74 @@
+#include "ChunkStore.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+ChunkStore::ChunkStore(std::filesystem::path directory) : directory_(std::move(directory)) {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (error) {
+        throw std::runtime_error("Failed to create world directory " + directory_.string() + ": " + error.message());
+    }
+}
+
+std::shared_ptr<DenseChunk> ChunkStore::load(const ChunkPos& position) {
+    RegionFile* file = region(RegionFile::region_of(position), false);
+    if (file == nullptr) {
+        return nullptr;
+    }
+    auto chunk = std::make_shared<DenseChunk>();
+    try {
+        if (!file->read(RegionFile::local_of(position), *chunk)) {
+            return nullptr;
+        }
+    } catch (const std::runtime_error& error) {
+        std::cerr << "Regenerating chunk " << position.x << ", " << position.y << ", " << position.z << ": "
+                  << error.what() << std::endl;
+        return nullptr;
+    }
+    return chunk;
+}
+
+bool ChunkStore::save(const ChunkPos& position, const DenseChunk& chunk) {
+    RegionFile* file = region(RegionFile::region_of(position), true);
+    if (file == nullptr) {
+        return false;
+    }
+    try {
+        file->write(RegionFile::local_of(position), chunk);
+    } catch (const std::runtime_error& error) {
+        std::cerr << "Failed to save chunk " << position.x << ", " << position.y << ", " << position.z << ": "
+                  << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+RegionFile* ChunkStore::region(const ChunkPos& region_position, const bool create) {
+    // Region files lock themselves; this only guards the map
+    std::lock_guard lock(mutex_);
+    const auto it = regions_.find(region_position);
+    if (it != regions_.end() && (it->second || !create)) {
+        return it->second.get();
+    }
+    if (broken_.contains(region_position)) {
+        return nullptr;
+    }
+
+    const auto path = directory_ / ("r." + std::to_string(region_position.x) + "." + std::to_string(region_position.y)
+                                    + "." + std::to_string(region_position.z) + ".region");
+    auto& file = regions_[region_position];
+    try {
+        if (create || std::filesystem::exists(path)) {
+            file = std::make_unique<RegionFile>(path);
+        }
+    } catch (const std::runtime_error& error) {
+        // Reported once; the region then reads as empty and ignores saves
+        std::cerr << "Ignoring region: " << error.what() << std::endl;
+        broken_.insert(region_position);
+    }
+    return file.get();
+}
@@ -0,0 +1,48 @@
+#ifndef CHUNK_STORE_H
+#define CHUNK_STORE_H
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Chunk.h"
+#include "RegionFile.h"
+
+// A world saved as a directory of region files, opened on first use.
+//
+// A region file that cannot be opened or read is reported once on stderr and then
+// treated as holding nothing; saves to it are dropped, leaving the file as it was.
+// A corrupt chunk is reported and loads as absent, so the caller regenerates it.
+// Neither ever throws out of load() or save(), which run on JobSystem workers.
+//
+// Thread-safe, so generators running on the JobSystem can load and save directly.
+class ChunkStore {
+public:
+    // Creates `directory` if needed. Throws std::runtime_error if that fails.
+    explicit ChunkStore(std::filesystem::path directory);
+
+    // Returns the saved chunk, or nullptr if `position` was never saved or cannot be read.
+    std::shared_ptr<DenseChunk> load(const ChunkPos& position);
+
+    // Returns false, after reporting why, if the chunk could not be written.
+    bool save(const ChunkPos& position, const DenseChunk& chunk);
+
+    [[nodiscard]]
+    const std::filesystem::path& directory() const { return directory_; }
+
+private:
+    // Returns nullptr when the region has no file and `create` is false, or when
+    // its file is unusable.
+    RegionFile* region(const ChunkPos& region_position, bool create);
+
+    std::filesystem::path directory_;
+    std::mutex mutex_;
+    // nullptr marks regions known to have no file yet
+    std::unordered_map<ChunkPos, std::unique_ptr<RegionFile>, ChunkPosHash> regions_;
+    // Regions whose file failed to open; never retried
+    std::unordered_set<ChunkPos, ChunkPosHash> broken_;
+};
+
+#endif //CHUNK_STORE_H
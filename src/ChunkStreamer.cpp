@@ -0,0 +1,553 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ranges>
+#include <utility>
+
+#include "glm/geometric.hpp"
+
+#include "ChunkOccluders.h"
+
+namespace {
+int floor_div(const int value, const int divisor) {
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+ChunkPos chunk_of(const glm::ivec3& block) {
+    return {floor_div(block.x, kChunkSize), floor_div(block.y, kChunkSize), floor_div(block.z, kChunkSize)};
+}
+
+// Calls fn(offset) for the offsets of the 26 chunks around a chunk.
+template<typename Fn>
+void for_each_neighbour(Fn&& fn) {
+    for (int y = -1; y <= 1; y++) {
+        for (int z = -1; z <= 1; z++) {
+            for (int x = -1; x <= 1; x++) {
+                if (x != 0 || y != 0 || z != 0) {
+                    fn(glm::ivec3(x, y, z));
+                }
+            }
+        }
+    }
+}
+
+// Whether `chunk` has a non-air block in the padding of its neighbour at `offset`,
+// i.e. on the face, edge or corner it shares with that neighbour.
+bool borders_solid(const DenseChunk& chunk, const glm::ivec3& offset) {
+    glm::ivec3 begin;
+    glm::ivec3 end;
+    for (int axis = 0; axis < 3; axis++) {
+        begin[axis] = offset[axis] > 0 ? kChunkSize - 1 : 0;
+        end[axis] = offset[axis] < 0 ? 1 : kChunkSize;
+    }
+    for (int y = begin.y; y < end.y; y++) {
+        for (int z = begin.z; z < end.z; z++) {
+            for (int x = begin.x; x < end.x; x++) {
+                if (chunk.get(x, y, z) != kAir) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+}
+
+ChunkStreamer::ChunkStreamer(JobSystem& jobs, ChunkMeshScheduler& mesh_scheduler, Generator generator,
+                             const Config& config, Saver saver)
+    : jobs_(jobs),
+      mesh_scheduler_(mesh_scheduler),
+      generator_(std::move(generator)),
+      saver_(std::move(saver)),
+      config_(config),
+      max_generating_(std::max<size_t>(jobs.worker_count() * 2, 1)),
+      generated_(std::make_shared<MpscQueue<Generated>>()) {
+    const int radius = config_.view_radius;
+    for (int z = -radius; z <= radius; z++) {
+        for (int x = -radius; x <= radius; x++) {
+            if (x * x + z * z <= radius * radius) {
+                offsets_.emplace_back(x, z);
+            }
+        }
+    }
+    if (config_.lighting) {
+        light_ = std::make_unique<LightEngine>([this](const ChunkPos& position) { return blocks_of(position); },
+                                               config_.max_chunk_y);
+    }
+    std::ranges::stable_sort(offsets_, {}, [](const glm::ivec2& offset) {
+        return offset.x * offset.x + offset.y * offset.y;
+    });
+}
+
+ChunkStreamer::~ChunkStreamer() {
+    save_edits();
+}
+
+void ChunkStreamer::save_edits() {
+    if (!saver_) {
+        return;
+    }
+    for (auto& [position, entry]: entries_) {
+        if (entry.unsaved || entry.edited) {
+            saver_(position, *blocks_of(position));
+            // Unpublished edits are saved again once published
+            entry.unsaved = false;
+        }
+    }
+}
+
+size_t ChunkStreamer::gpu_size(const MeshData& mesh) {
+    return mesh.vertices.size() * sizeof(glm::vec3)
+        + mesh.packed.size() * sizeof(PackedVertex)
+        + mesh.colors.size() * sizeof(Color)
+        + mesh.indices.size() * sizeof(unsigned int);
+}
+
+ChunkPos ChunkStreamer::chunk_at(const glm::vec3& world_position) const {
+    const glm::vec3 local = (world_position - config_.origin) / static_cast<float>(kChunkSize);
+    return {
+        static_cast<int>(std::floor(local.x)),
+        static_cast<int>(std::floor(local.y)),
+        static_cast<int>(std::floor(local.z)),
+    };
+}
+
+glm::vec3 ChunkStreamer::world_origin(const ChunkPos& position) const {
+    return config_.origin + glm::vec3(position) * static_cast<float>(kChunkSize);
+}
+
+bool ChunkStreamer::make_room(const size_t cpu_bytes) {
+    while (cpu_bytes_ + cpu_bytes > config_.cpu_budget_bytes || gpu_bytes_ > config_.gpu_budget_bytes) {
+        if (!evict_one()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ChunkStreamer::update(const glm::vec3& camera_position) {
+    tick_++;
+    camera_position_ = camera_position;
+    publish_edits();
+
+    for (size_t i = 0; i < config_.max_results_per_update; i++) {
+        auto generated = generated_->try_pop();
+        if (!generated) {
+            break;
+        }
+        apply_generated(std::move(*generated));
+    }
+    if (light_) {
+        // Meshes the chunks just lit for the first time, and their neighbours where
+        // the light on the border changed
+        for (const ChunkPos& position: light_->propagate(jobs_)) {
+            const auto it = entries_.find(position);
+            if (it != entries_.end() && it->second.chunk
+                && (it->second.lod == 0 || it->second.state == State::Meshing)) {
+                request_mesh(it->second, position);
+            }
+        }
+    }
+    for (size_t i = 0; i < config_.max_results_per_update; i++) {
+        auto result = mesh_scheduler_.poll();
+        if (!result) {
+            break;
+        }
+        apply_mesh(std::move(*result));
+    }
+
+    // Mark everything in view as used, farthest first so the nearest end up at the
+    // front of the LRU list and the farthest are the first to go once out of view
+    const ChunkPos center = chunk_at(camera_position);
+    for (auto offset = offsets_.rbegin(); offset != offsets_.rend(); ++offset) {
+        for (int y = config_.min_chunk_y; y <= config_.max_chunk_y; y++) {
+            const auto it = entries_.find({center.x + offset->x, y, center.z + offset->y});
+            if (it != entries_.end()) {
+                it->second.last_seen = tick_;
+                lru_.splice(lru_.begin(), lru_, it->second.lru);
+                update_lod(it->second, it->first);
+            }
+        }
+    }
+
+    make_room(0);
+    load_missing(center);
+
+    mesh_scheduler_.dispatch(camera_position - config_.origin);
+}
+
+bool ChunkStreamer::set_block(const glm::ivec3& block, const BlockId id) {
+    const ChunkPos position = chunk_of(block);
+    const auto it = entries_.find(position);
+    if (it == entries_.end() || it->second.state == State::Generating) {
+        return false;
+    }
+    Entry& entry = it->second;
+    const glm::ivec3 local = block - position * kChunkSize;
+    if (!entry.edited) {
+        const BlockId current = entry.chunk ? entry.chunk->get(local.x, local.y, local.z) : kAir;
+        if (current == id) {
+            return true;
+        }
+        if (entry.chunk) {
+            entry.edited = std::make_shared<DenseChunk>(*entry.chunk);
+        } else {
+            // An all-air chunk gets block data for the first time
+            entry.edited = std::make_shared<DenseChunk>();
+            cpu_bytes_ += sizeof(DenseChunk);
+        }
+        edited_.push_back(position);
+    }
+    entry.edited->set(local.x, local.y, local.z, id);
+    edited_blocks_.push_back(block);
+    return true;
+}
+
+BlockId ChunkStreamer::get_block(const glm::ivec3& block) const {
+    const ChunkPos position = chunk_of(block);
+    const auto it = entries_.find(position);
+    if (it == entries_.end()) {
+        return kAir;
+    }
+    const glm::ivec3 local = block - position * kChunkSize;
+    if (it->second.edited) {
+        return it->second.edited->get(local.x, local.y, local.z);
+    }
+    return it->second.chunk ? it->second.chunk->get(local.x, local.y, local.z) : kAir;
+}
+
+std::optional<raycast::Hit> ChunkStreamer::raycast(const glm::vec3& origin, const glm::vec3& direction,
+                                                   const float max_distance) const {
+    return raycast::trace({origin - config_.origin, direction, max_distance},
+                          [this](const ChunkPos& position) { return blocks_of(position); });
+}
+
+void ChunkStreamer::raycast(const std::span<const raycast::Ray> rays,
+                            const std::span<std::optional<raycast::Hit>> hits) const {
+    std::vector<raycast::Ray> local(rays.begin(), rays.end());
+    for (raycast::Ray& ray: local) {
+        ray.origin -= config_.origin;
+    }
+    raycast::trace_batch(jobs_, local, hits, [this](const ChunkPos& position) { return blocks_of(position); });
+}
+
+const DenseChunk* ChunkStreamer::blocks_of(const ChunkPos& position) const {
+    const auto it = entries_.find(position);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+    return it->second.edited ? it->second.edited.get() : it->second.chunk.get();
+}
+
+void ChunkStreamer::publish_edits() {
+    last_edited_chunks_ = edited_.size();
+    if (edited_.empty()) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<ChunkPos> remesh = std::move(edited_);
+    edited_.clear();
+    for (const ChunkPos& position: remesh) {
+        Entry& entry = entries_.at(position);
+        entry.chunk = std::move(entry.edited);
+        entry.unsaved = true;
+        entry.occluders = occlusion::chunk_occluders(*entry.chunk, world_origin(position));
+    }
+    const auto add_remesh = [&](const ChunkPos& position) {
+        if (std::ranges::find(remesh, position) == remesh.end()) {
+            remesh.push_back(position);
+        }
+    };
+    // A block on a border also lies in the padding of the full-detail neighbours it touches
+    for (const glm::ivec3& block: edited_blocks_) {
+        const ChunkPos position = chunk_of(block);
+        const glm::ivec3 local = block - position * kChunkSize;
+        for_each_neighbour([&](const glm::ivec3& offset) {
+            for (int axis = 0; axis < 3; axis++) {
+                if ((offset[axis] < 0 && local[axis] != 0) || (offset[axis] > 0 && local[axis] != kChunkSize - 1)) {
+                    return;
+                }
+            }
+            const auto it = entries_.find(position + offset);
+            if (it != entries_.end() && it->second.chunk && it->second.lod == 0) {
+                add_remesh(it->first);
+            }
+        });
+    }
+    if (light_) {
+        for (const glm::ivec3& block: edited_blocks_) {
+            light_->block_changed(block);
+        }
+        for (const ChunkPos& position: light_->propagate(jobs_)) {
+            add_remesh(position);
+        }
+    }
+    edited_blocks_.clear();
+
+    std::vector<ChunkMeshScheduler::ImmediateRequest> requests;
+    requests.reserve(remesh.size());
+    for (const ChunkPos& position: remesh) {
+        const auto it = entries_.find(position);
+        if (it != entries_.end() && it->second.chunk) {
+            const Entry& entry = it->second;
+            requests.push_back({position, entry.chunk, entry.lod, light_snapshot(position, entry.lod),
+                                neighbour_snapshot(position, entry.lod)});
+        }
+    }
+
+    // Bypasses max_results_per_update: these are what the user is looking at
+    for (ChunkMeshResult& result: mesh_scheduler_.mesh_now(requests)) {
+        apply_mesh(std::move(result));
+    }
+    last_edit_time_us_ = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ChunkStreamer::load_missing(const ChunkPos& center) {
+    for (const glm::ivec2& offset: offsets_) {
+        for (int y = config_.min_chunk_y; y <= config_.max_chunk_y; y++) {
+            if (generating_ >= max_generating_) {
+                return;
+            }
+            const ChunkPos position(center.x + offset.x, y, center.z + offset.y);
+            if (entries_.contains(position)) {
+                continue;
+            }
+            if (!make_room(sizeof(DenseChunk) + light_bytes())) {
+                // Everything resident is in view; the rest of the radius does not fit
+                return;
+            }
+            start_generation(position);
+        }
+    }
+}
+
+void ChunkStreamer::update_visibility(const glm::vec3& camera_position, const Frustum& frustum) {
+    visibility_pass_++;
+    visited_chunks_ = 0;
+    if (!cave_culling_) {
+        return;
+    }
+
+    // One layer of open air above and below the world lets the walk pass over
+    // and under it; beyond the view radius there is nothing loaded to reach
+    const ChunkPos camera = chunk_at(camera_position);
+    const int min_y = config_.min_chunk_y - 1;
+    const int max_y = config_.max_chunk_y + 1;
+    const int radius = config_.view_radius + 1;
+    const ChunkPos start(camera.x, std::clamp(camera.y, min_y, max_y), camera.z);
+
+    const auto visibility_of = [&](const ChunkPos& position, ChunkVisibility& out) {
+        const int dx = position.x - camera.x;
+        const int dz = position.z - camera.z;
+        if (position.y < min_y || position.y > max_y || dx * dx + dz * dz > radius * radius) {
+            return false;
+        }
+        const auto it = entries_.find(position);
+        out = it != entries_.end() ? it->second.visibility : ChunkVisibility::all_open();
+        return true;
+    };
+    const auto visit = [&](const ChunkPos& position) {
+        const auto it = entries_.find(position);
+        if (it != entries_.end()) {
+            it->second.visible_pass = visibility_pass_;
+        }
+    };
+    visited_chunks_ = visibility::traverse(start, frustum, config_.origin, visibility_of, visit);
+}
+
+float ChunkStreamer::chunk_distance(const ChunkPos& position) const {
+    constexpr float half = static_cast<float>(kChunkSize) * 0.5f;
+    return glm::length(world_origin(position) + half - camera_position_) / static_cast<float>(kChunkSize);
+}
+
+void ChunkStreamer::update_lod(Entry& entry, const ChunkPos& position) {
+    if (!entry.chunk || config_.lod_distance <= 0.0f) {
+        return;
+    }
+    const int level = lod::select_level(chunk_distance(position), entry.lod, config_.lod_distance,
+                                        config_.lod_hysteresis);
+    if (level == entry.lod) {
+        return;
+    }
+    entry.lod = level;
+    request_mesh(entry, position);
+}
+
+std::array<size_t, lod::kLevels> ChunkStreamer::lod_histogram() const {
+    std::array<size_t, lod::kLevels> histogram{};
+    for (const Entry& entry: entries_ | std::views::values) {
+        if (entry.mesh) {
+            histogram[entry.mesh_lod]++;
+        }
+    }
+    return histogram;
+}
+
+void ChunkStreamer::remesh_all() {
+    for (auto& [position, entry]: entries_) {
+        if (entry.chunk) {
+            request_mesh(entry, position);
+        }
+    }
+}
+
+ChunkMeshScheduler::Neighbours ChunkStreamer::neighbour_snapshot(const ChunkPos& position, const int lod) const {
+    ChunkMeshScheduler::Neighbours neighbours;
+    if (lod != 0) {
+        return neighbours;
+    }
+    for_each_neighbour([&](const glm::ivec3& offset) {
+        const auto it = entries_.find(position + offset);
+        if (it != entries_.end()) {
+            neighbours[ChunkMeshScheduler::neighbour_index(offset)] = it->second.chunk;
+        }
+    });
+    return neighbours;
+}
+
+ChunkMeshScheduler::LightSnapshot ChunkStreamer::light_snapshot(const ChunkPos& position, const int lod) const {
+    if (!light_ || lod != 0) {
+        return nullptr;
+    }
+    auto volume = std::make_shared<LightVolume>();
+    light_->fill_volume(position, *volume);
+    return volume;
+}
+
+void ChunkStreamer::request_mesh(Entry& entry, const ChunkPos& position) {
+    mesh_scheduler_.request(position, entry.chunk, entry.lod, JobSystem::Priority::Normal,
+                            light_snapshot(position, entry.lod), neighbour_snapshot(position, entry.lod));
+    if (entry.state == State::Ready) {
+        entry.state = State::Meshing;
+    }
+}
+
+void ChunkStreamer::start_generation(const ChunkPos& position) {
+    Entry& entry = entries_[position];
+    lru_.push_front(position);
+    entry.lru = lru_.begin();
+    entry.last_seen = tick_;
+    cpu_bytes_ += sizeof(DenseChunk) + light_bytes();
+    generating_++;
+
+    jobs_.submit([generated = generated_, generator = generator_, position, origin = world_origin(position)] {
+        auto chunk = generator(position);
+        auto occluders = chunk ? occlusion::chunk_occluders(*chunk, origin) : std::vector<Aabb>{};
+        generated->push(Generated{position, std::move(chunk), std::move(occluders)});
+    });
+}
+
+void ChunkStreamer::apply_generated(Generated generated) {
+    generating_--;
+    const auto it = entries_.find(generated.position);
+    if (it == entries_.end() || it->second.state != State::Generating) {
+        // Evicted while generating; its reservation was released then
+        return;
+    }
+    Entry& entry = it->second;
+    if (!generated.chunk) {
+        // All air: keep the entry so the chunk is not generated again, but drop the reservation
+        cpu_bytes_ -= sizeof(DenseChunk);
+        entry.state = State::Ready;
+        if (light_) {
+            light_->add_chunk(generated.position);
+        }
+        return;
+    }
+    entry.chunk = std::move(generated.chunk);
+    entry.occluders = std::move(generated.occluders);
+    entry.state = State::Meshing;
+    entry.lod = lod::level_for(chunk_distance(generated.position), config_.lod_distance);
+    if (light_) {
+        // Meshed by update() once propagate() has lit it
+        light_->add_chunk(generated.position);
+    } else {
+        request_mesh(entry, generated.position);
+    }
+
+    // Full-detail neighbours were meshed with air where its border blocks are now
+    for_each_neighbour([&](const glm::ivec3& offset) {
+        const auto neighbour = entries_.find(generated.position + offset);
+        if (neighbour != entries_.end() && neighbour->second.chunk && neighbour->second.lod == 0
+            && borders_solid(*entry.chunk, offset)) {
+            request_mesh(neighbour->second, neighbour->first);
+        }
+    });
+}
+
+void ChunkStreamer::apply_mesh(ChunkMeshResult result) {
+    const auto it = entries_.find(result.position);
+    if (it == entries_.end()) {
+        return;
+    }
+    last_mesh_time_us_ = result.mesh_time_us;
+    it->second.state = State::Ready;
+    it->second.visibility = result.visibility;
+    it->second.mesh_lod = result.lod;
+    set_mesh(it->second, result.position, std::move(result.mesh));
+}
+
+void ChunkStreamer::set_mesh(Entry& entry, const ChunkPos& position, MeshHandle mesh) {
+    if (entry.mesh) {
+        gpu_bytes_ -= gpu_size(*entry.mesh);
+        quads_ -= entry.mesh->indices.size() / 6;
+    }
+    if (mesh && mesh->indices.empty()) {
+        // Fully enclosed or empty: nothing to draw
+        mesh.reset();
+    }
+    entry.mesh = std::move(mesh);
+
+    if (!entry.mesh) {
+        entry.object.reset();
+        return;
+    }
+    gpu_bytes_ += gpu_size(*entry.mesh);
+    quads_ += entry.mesh->indices.size() / 6;
+
+    if (!entry.object) {
+        entry.object = std::make_unique<GameObject>("Chunk");
+        entry.object->add_component(std::make_unique<MeshComponent>());
+        entry.object->transform.set_position(world_origin(position));
+        entry.object->transform.set_scale(glm::vec3(1.0f));
+    }
+    entry.object->get_component<MeshComponent>()->mesh = entry.mesh;
+}
+
+bool ChunkStreamer::evict_one() {
+    for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+        const Entry& entry = entries_.at(*it);
+        if (entry.last_seen == tick_) {
+            // This chunk is in view, so everything seen more recently is
+            return false;
+        }
+        if (!entry.unsaved || saver_) {
+            const ChunkPos position = *it;
+            evict(position);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ChunkStreamer::evict(const ChunkPos& position) {
+    const auto it = entries_.find(position);
+    Entry& entry = it->second;
+    if (entry.unsaved && saver_) {
+        saver_(position, *entry.chunk);
+    }
+    if (entry.chunk || entry.state == State::Generating) {
+        cpu_bytes_ -= sizeof(DenseChunk);
+    }
+    cpu_bytes_ -= light_bytes();
+    if (light_) {
+        light_->remove_chunk(position);
+    }
+    // Dropping the handle lets the Renderer release the GPU buffers at end_frame()
+    set_mesh(entry, position, nullptr);
+    mesh_scheduler_.cancel(position);
+    lru_.erase(entry.lru);
+    entries_.erase(it);
+}
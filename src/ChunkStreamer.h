@@ -0,0 +1,326 @@
+#ifndef CHUNK_STREAMER_H
+#define CHUNK_STREAMER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Bounds.h"
+#include "Chunk.h"
+#include "ChunkLod.h"
+#include "ChunkMeshScheduler.h"
+#include "ChunkVisibility.h"
+#include "Frustum.h"
+#include "GameObject.h"
+#include "JobSystem.h"
+#include "LightEngine.h"
+#include "MeshComponent.h"
+#include "MeshRegistry.h"
+#include "MpscQueue.h"
+#include "VoxelRaycast.h"
+
+// Keeps the chunks around the camera resident: generates them on the JobSystem,
+// meshes them through a ChunkMeshScheduler and hands the results to the renderer
+// as GameObjects.
+//
+// Chunks that leave the view radius stay cached until the CPU or GPU budget runs
+// out; then the least recently viewed ones are evicted first (and, among chunks
+// last seen in the same update, the farthest). Chunks inside the view radius are
+// never evicted: when they alone would exceed a budget, the farthest ones are
+// simply not loaded. Nothing is loaded up front.
+//
+// With lod_distance set, chunks farther away are meshed at a lower level of
+// detail (see ChunkLod.h), re-selected every update with hysteresis. A chunk
+// keeps drawing its previous mesh until the one at its new level arrives.
+//
+// Block edits are collected on a private copy of each touched chunk and published
+// by the next update(), which remeshes exactly those chunks before returning, on
+// the calling thread and the pool's high priority lane, so an edit is visible in
+// the frame that follows it however much streaming work is queued.
+//
+// Full-detail meshes see one block into the 26 neighbouring chunks, so no faces
+// are left between two solid chunks; a neighbour that is not loaded yet counts as
+// air, and its arrival remeshes the full-detail chunks its border blocks touch.
+// Likewise, an edit on a chunk border also remeshes those neighbours.
+//
+// Edited chunks are written back through the Saver when they are evicted, and on
+// destruction or save_edits(). Without a Saver, edited chunks are never evicted,
+// so edits are kept for the streamer's lifetime at the cost of their budget.
+// Coarser levels mesh each chunk on its own.
+//
+// With lighting on, a LightEngine tracks the light of every resident chunk and
+// full-detail meshes are built with it baked in. New chunks are meshed once they
+// are lit, and any chunk whose light an edit or a new neighbour changed is
+// remeshed with them; for edits that happens within the same update().
+//
+// Not thread-safe: driven by one thread at a time, normally the render thread.
+class ChunkStreamer {
+public:
+    // Runs on worker threads. Returns nullptr for chunks that are entirely air,
+    // which then cost no memory and are never meshed.
+    using Generator = std::function<std::shared_ptr<DenseChunk>(const ChunkPos&)>;
+    // Stores an edited chunk so the Generator returns it from then on. Runs on the
+    // calling thread of update() or save_edits().
+    using Saver = std::function<void(const ChunkPos&, const DenseChunk&)>;
+
+    struct Config {
+        // Horizontal load radius, in chunks
+        int view_radius{8};
+        // Vertical extent of the world, in chunks
+        int min_chunk_y{0};
+        int max_chunk_y{0};
+        // Block data of resident and generating chunks
+        size_t cpu_budget_bytes{256u << 20};
+        // Geometry of resident chunk meshes
+        size_t gpu_budget_bytes{256u << 20};
+        // Finished generations and meshes applied per update(); bounds frame time spikes
+        size_t max_results_per_update{8};
+        // World-space position of block (0, 0, 0) of chunk (0, 0, 0)
+        glm::vec3 origin{0.0f};
+        // Distance from the camera, in chunks, beyond which chunks are meshed at
+        // LOD 1; each further level starts at twice the distance. 0 disables LOD
+        float lod_distance{0.0f};
+        // Fraction of a level's distance a chunk must cross past it to switch level
+        float lod_hysteresis{0.15f};
+        // Sky and block light (see LightEngine.h); off draws everything fully lit
+        bool lighting{true};
+    };
+
+    ChunkStreamer(JobSystem& jobs, ChunkMeshScheduler& mesh_scheduler, Generator generator, const Config& config,
+                  Saver saver = nullptr);
+    // Saves the edits still unsaved.
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    // Loads around `camera_position`, collects finished work and evicts over budget.
+    void update(const glm::vec3& camera_position);
+
+    // Re-meshes every resident chunk, e.g. after switching mesher backend.
+    void remesh_all();
+
+    // Hands every resident chunk edited since it was last saved to the Saver,
+    // including edits not published yet. Does nothing without a Saver.
+    void save_edits();
+
+    // Sets the block at `block`, in block coordinates (chunk p spans p * kChunkSize
+    // to (p + 1) * kChunkSize). Any number of edits to a chunk cost one copy and
+    // one remesh at the next update(), plus relighting and, for blocks on a border,
+    // remeshing the neighbours they touch. Returns false if the chunk is not loaded yet.
+    bool set_block(const glm::ivec3& block, BlockId id);
+
+    // The block at `block`, including edits not published yet; air where nothing is loaded.
+    [[nodiscard]]
+    BlockId get_block(const glm::ivec3& block) const;
+
+    // First block a world-space ray hits within `max_distance`, including edits not
+    // published yet; chunks that are not loaded count as air. The hit is in block
+    // coordinates, as set_block() takes them.
+    [[nodiscard]]
+    std::optional<raycast::Hit> raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const;
+
+    // Traces world-space `rays` into `hits` across the JobSystem's workers. Nothing
+    // may edit or update() the streamer meanwhile.
+    void raycast(std::span<const raycast::Ray> rays, std::span<std::optional<raycast::Hit>> hits) const;
+
+    // Walks the chunks reachable from the camera through open faces (see
+    // visibility::traverse). While cave culling is on, for_each_object() only
+    // reports the chunks reached by the latest walk. Call after update().
+    void update_visibility(const glm::vec3& camera_position, const Frustum& frustum);
+
+    void set_cave_culling(const bool enabled) { cave_culling_ = enabled; }
+
+    [[nodiscard]]
+    bool cave_culling() const { return cave_culling_; }
+
+    // Calls fn(const GameObject&) for each chunk that has a mesh.
+    template<typename Fn>
+    void for_each_object(Fn&& fn) const {
+        for (const auto& [position, entry]: entries_) {
+            if (entry.object && (!cave_culling_ || entry.visible_pass == visibility_pass_)) {
+                fn(*entry.object);
+            }
+        }
+    }
+
+    // Calls fn(const Aabb&) for the world-space occluder boxes of every resident
+    // chunk drawn at full detail. A coarser mesh may not cover its chunk's occluders.
+    template<typename Fn>
+    void for_each_occluder(Fn&& fn) const {
+        for (const auto& [position, entry]: entries_) {
+            if (entry.mesh_lod != 0) {
+                continue;
+            }
+            for (const Aabb& occluder: entry.occluders) {
+                fn(occluder);
+            }
+        }
+    }
+
+    [[nodiscard]]
+    const Config& config() const { return config_; }
+
+    [[nodiscard]]
+    size_t resident_chunks() const { return entries_.size(); }
+
+    [[nodiscard]]
+    size_t generating() const { return generating_; }
+
+    [[nodiscard]]
+    size_t cpu_bytes() const { return cpu_bytes_; }
+
+    [[nodiscard]]
+    size_t gpu_bytes() const { return gpu_bytes_; }
+
+    [[nodiscard]]
+    size_t quads() const { return quads_; }
+
+    [[nodiscard]]
+    double last_mesh_time_us() const { return last_mesh_time_us_; }
+
+    // Chunks the latest update() published edits for, and the time spent relighting
+    // and remeshing them.
+    [[nodiscard]]
+    size_t last_edited_chunks() const { return last_edited_chunks_; }
+
+    [[nodiscard]]
+    double last_edit_time_us() const { return last_edit_time_us_; }
+
+    // Light at `block`, in block coordinates; full sky light with lighting off.
+    [[nodiscard]]
+    light::Level light_at(const glm::ivec3& block) const {
+        return light_ ? light_->get(block) : light::kFullSky;
+    }
+
+    // Null with lighting off.
+    [[nodiscard]]
+    const LightEngine* light_engine() const { return light_.get(); }
+
+    // Chunks with a mesh, per level of detail.
+    [[nodiscard]]
+    std::array<size_t, lod::kLevels> lod_histogram() const;
+
+    // Chunk positions reached by the latest update_visibility(), loaded or not.
+    [[nodiscard]]
+    size_t visited_chunks() const { return visited_chunks_; }
+
+    // Estimated GPU footprint of a mesh's vertex and index buffers.
+    static size_t gpu_size(const MeshData& mesh);
+
+private:
+    enum class State : std::uint8_t {
+        Generating,
+        Meshing,
+        Ready,
+    };
+
+    struct Entry {
+        State state{State::Generating};
+        std::shared_ptr<const DenseChunk> chunk;
+        // Copy of `chunk` with the edits since the last update(), which publishes it
+        std::shared_ptr<DenseChunk> edited;
+        // Edited since last handed to the Saver, which must happen before eviction
+        bool unsaved{false};
+        MeshHandle mesh;
+        std::unique_ptr<GameObject> object;
+        // Solid boxes for occlusion culling, in world space
+        std::vector<Aabb> occluders;
+        // Unknown until the first mesh, so treated as open
+        ChunkVisibility visibility{ChunkVisibility::all_open()};
+        std::uint64_t visible_pass{0};
+        // Level requested last, and the level of `mesh`
+        int lod{0};
+        int mesh_lod{0};
+        std::list<ChunkPos>::iterator lru;
+        std::uint64_t last_seen{0};
+    };
+
+    struct Generated {
+        ChunkPos position;
+        std::shared_ptr<DenseChunk> chunk;
+        std::vector<Aabb> occluders;
+    };
+
+    [[nodiscard]]
+    ChunkPos chunk_at(const glm::vec3& world_position) const;
+    [[nodiscard]]
+    glm::vec3 world_origin(const ChunkPos& position) const;
+    // Latest blocks of a loaded chunk, or nullptr if it has none (yet).
+    [[nodiscard]]
+    const DenseChunk* blocks_of(const ChunkPos& position) const;
+    // Evicts out-of-view chunks until `cpu_bytes` more fit in both budgets.
+    bool make_room(size_t cpu_bytes);
+    void load_missing(const ChunkPos& center);
+    // Publishes the edited chunks and remeshes them before returning.
+    void publish_edits();
+    void start_generation(const ChunkPos& position);
+    void apply_generated(Generated generated);
+    void apply_mesh(ChunkMeshResult result);
+    // Published neighbours for meshing the chunk at `lod`; none for coarser levels.
+    [[nodiscard]]
+    ChunkMeshScheduler::Neighbours neighbour_snapshot(const ChunkPos& position, int lod) const;
+    // Light for meshing the chunk at `lod`; none for coarser levels, which are unlit.
+    [[nodiscard]]
+    ChunkMeshScheduler::LightSnapshot light_snapshot(const ChunkPos& position, int lod) const;
+    // Queues a mesh of the chunk at its current level.
+    void request_mesh(Entry& entry, const ChunkPos& position);
+    // Light tracked per resident chunk, on top of its blocks.
+    [[nodiscard]]
+    size_t light_bytes() const { return light_ ? sizeof(LightChunk) : 0; }
+    void set_mesh(Entry& entry, const ChunkPos& position, MeshHandle mesh);
+    // Distance from the camera to the chunk's center, in chunks.
+    [[nodiscard]]
+    float chunk_distance(const ChunkPos& position) const;
+    // Re-selects the chunk's level and remeshes it if that changed.
+    void update_lod(Entry& entry, const ChunkPos& position);
+    // Evicts the least recently seen chunk that is outside the view radius and
+    // can be evicted; unsaved edits can only be without a Saver.
+    bool evict_one();
+    void evict(const ChunkPos& position);
+
+    JobSystem& jobs_;
+    ChunkMeshScheduler& mesh_scheduler_;
+    Generator generator_;
+    Saver saver_;
+    Config config_;
+    size_t max_generating_;
+
+    // Horizontal offsets within the view radius, nearest first
+    std::vector<glm::ivec2> offsets_;
+
+    std::unordered_map<ChunkPos, Entry, ChunkPosHash> entries_;
+    // Front: seen most recently. Chunks in view are moved to the front every update
+    std::list<ChunkPos> lru_;
+    std::uint64_t tick_{0};
+    glm::vec3 camera_position_{0.0f};
+
+    // Chunks with unpublished edits, in the order they were first touched
+    std::vector<ChunkPos> edited_;
+    // Blocks set since the last update(), to relight and to find border edits
+    std::vector<glm::ivec3> edited_blocks_;
+
+    std::unique_ptr<LightEngine> light_;
+
+    std::shared_ptr<MpscQueue<Generated>> generated_;
+    size_t generating_{0};
+    size_t cpu_bytes_{0};
+    size_t gpu_bytes_{0};
+    size_t quads_{0};
+    double last_mesh_time_us_{0.0};
+    size_t last_edited_chunks_{0};
+    double last_edit_time_us_{0.0};
+
+    bool cave_culling_{true};
+    std::uint64_t visibility_pass_{0};
+    size_t visited_chunks_{0};
+};
+
+#endif //CHUNK_STREAMER_H
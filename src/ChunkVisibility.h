@@ -0,0 +1,208 @@
+#ifndef CHUNK_VISIBILITY_H
+#define CHUNK_VISIBILITY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Bounds.h"
+#include "Chunk.h"
+#include "Frustum.h"
+
+// Which faces of a chunk can see each other through its non-opaque blocks: faces
+// A and B are connected when a single air pocket touches both. Stored as a
+// symmetric 6x6 bit matrix.
+class ChunkVisibility {
+public:
+    static constexpr ChunkVisibility all_open() {
+        ChunkVisibility visibility;
+        visibility.bits_ = (std::uint64_t{1} << 36) - 1;
+        return visibility;
+    }
+
+    constexpr void connect(const Face a, const Face b) {
+        bits_ |= bit(a, b) | bit(b, a);
+    }
+
+    [[nodiscard]]
+    constexpr bool connected(const Face a, const Face b) const {
+        return (bits_ & bit(a, b)) != 0;
+    }
+
+    [[nodiscard]]
+    constexpr bool closed() const { return bits_ == 0; }
+
+    constexpr bool operator==(const ChunkVisibility&) const = default;
+
+private:
+    static constexpr std::uint64_t bit(const Face a, const Face b) {
+        return std::uint64_t{1} << (static_cast<int>(a) * 6 + static_cast<int>(b));
+    }
+
+    std::uint64_t bits_{0};
+};
+
+namespace visibility {
+
+// Flood fills every air pocket that reaches the boundary of `chunk` and connects
+// the faces it touches. Cheap enough to run next to meshing on every remesh.
+template<typename ChunkT>
+ChunkVisibility compute(const ChunkT& chunk) {
+    constexpr int size = ChunkT::kSize;
+    constexpr size_t volume = static_cast<size_t>(size) * size * size;
+    static_assert(volume <= 65536, "Cell indices are stored as 16 bits");
+
+    // Opaque blocks start out as visited, so the fill only ever walks open cells
+    std::vector<bool> visited(volume);
+    size_t open = 0;
+    for (int y = 0; y < size; y++) {
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) {
+                const bool opaque = is_opaque(chunk.get(x, y, z));
+                visited[(static_cast<size_t>(y) * size + z) * size + x] = opaque;
+                open += opaque ? 0 : 1;
+            }
+        }
+    }
+    if (open == volume) {
+        return ChunkVisibility::all_open();
+    }
+
+    ChunkVisibility result;
+    if (open == 0) {
+        return result;
+    }
+
+    std::vector<std::uint16_t> stack;
+    const auto fill = [&](const int seed_x, const int seed_y, const int seed_z) {
+        const size_t seed = (static_cast<size_t>(seed_y) * size + seed_z) * size + seed_x;
+        if (visited[seed]) {
+            return;
+        }
+        visited[seed] = true;
+        stack.push_back(static_cast<std::uint16_t>(seed));
+
+        std::uint8_t faces = 0;
+        while (!stack.empty()) {
+            const size_t cell = stack.back();
+            stack.pop_back();
+            const int x = static_cast<int>(cell % size);
+            const int z = static_cast<int>(cell / size % size);
+            const int y = static_cast<int>(cell / (static_cast<size_t>(size) * size));
+            faces |= static_cast<std::uint8_t>((x == 0) << static_cast<int>(Face::NegX)
+                | (x == size - 1) << static_cast<int>(Face::PosX)
+                | (y == 0) << static_cast<int>(Face::NegY)
+                | (y == size - 1) << static_cast<int>(Face::PosY)
+                | (z == 0) << static_cast<int>(Face::NegZ)
+                | (z == size - 1) << static_cast<int>(Face::PosZ));
+
+            const auto visit = [&](const bool inside, const size_t neighbor) {
+                if (inside && !visited[neighbor]) {
+                    visited[neighbor] = true;
+                    stack.push_back(static_cast<std::uint16_t>(neighbor));
+                }
+            };
+            constexpr size_t row = size;
+            constexpr size_t layer = static_cast<size_t>(size) * size;
+            visit(x > 0, cell - 1);
+            visit(x < size - 1, cell + 1);
+            visit(z > 0, cell - row);
+            visit(z < size - 1, cell + row);
+            visit(y > 0, cell - layer);
+            visit(y < size - 1, cell + layer);
+        }
+
+        for (int a = 0; a < 6; a++) {
+            for (int b = a; b < 6; b++) {
+                if ((faces >> a & 1) && (faces >> b & 1)) {
+                    result.connect(static_cast<Face>(a), static_cast<Face>(b));
+                }
+            }
+        }
+    };
+
+    // Pockets that never reach the boundary cannot connect faces, so only
+    // boundary cells need to seed a fill
+    for (int a = 0; a < size; a++) {
+        for (int b = 0; b < size; b++) {
+            fill(0, a, b);
+            fill(size - 1, a, b);
+            fill(a, 0, b);
+            fill(a, size - 1, b);
+            fill(a, b, 0);
+            fill(a, b, size - 1);
+        }
+    }
+    return result;
+}
+
+// Cave culling: walks outwards from `start`, entering a neighbour only through a
+// face that the current chunk connects to the face it was entered by, and never
+// stepping against a direction already taken, so the walk keeps heading away from
+// the camera. Neighbours outside `frustum` are skipped.
+//
+// `visibility_of(position, ChunkVisibility& out)` returns false for positions the
+// walk must not enter (outside the world) and otherwise fills in `out`.
+// `visit(position)` is called once per chunk reached, including `start`. `origin`
+// is the world position of block (0, 0, 0) of chunk (0, 0, 0). Returns the number
+// of chunks visited.
+template<typename VisibilityOf, typename Visit>
+size_t traverse(const ChunkPos& start, const Frustum& frustum, const glm::vec3& origin,
+                VisibilityOf&& visibility_of, Visit&& visit) {
+    struct Node {
+        ChunkPos position;
+        // Face of `position` the walk came in through; kNoFace for the start chunk
+        std::uint8_t entered;
+        // Bit d set once the walk has stepped in direction d
+        std::uint8_t directions;
+        ChunkVisibility visibility;
+    };
+    constexpr std::uint8_t kNoFace = 6;
+
+    std::vector<Node> queue{{start, kNoFace, 0, {}}};
+    if (!visibility_of(start, queue.front().visibility)) {
+        return 0;
+    }
+    std::unordered_set<ChunkPos, ChunkPosHash> reached{start};
+    visit(start);
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        const Node node = queue[head];
+        for (int direction = 0; direction < 6; direction++) {
+            // Faces come in opposite pairs: NegX/PosX, NegY/PosY, NegZ/PosZ
+            const int opposite = direction ^ 1;
+            if (node.directions >> opposite & 1) {
+                continue;
+            }
+            if (node.entered != kNoFace
+                && !node.visibility.connected(static_cast<Face>(node.entered), static_cast<Face>(direction))) {
+                continue;
+            }
+            const ChunkPos next = node.position + kFaceNormals[direction];
+            if (reached.contains(next)) {
+                continue;
+            }
+            const glm::vec3 low = origin + glm::vec3(next) * static_cast<float>(kChunkSize);
+            if (!frustum.intersects(Aabb{low, low + static_cast<float>(kChunkSize)})) {
+                continue;
+            }
+            reached.insert(next);
+            Node neighbor{next, static_cast<std::uint8_t>(opposite),
+                          static_cast<std::uint8_t>(node.directions | 1 << direction), {}};
+            if (!visibility_of(next, neighbor.visibility)) {
+                continue;
+            }
+            visit(next);
+            queue.push_back(neighbor);
+        }
+    }
+    return queue.size();
+}
+
+}
+
+#endif //CHUNK_VISIBILITY_H
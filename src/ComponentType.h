@@ -0,0 +1,33 @@
+#ifndef COMPONENT_TYPE_H
+#define COMPONENT_TYPE_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+
+namespace ecs {
+
+// Component masks are 64-bit, so at most this many distinct component types.
+static constexpr size_t kMaxComponentTypes = 64;
+
+inline std::atomic<size_t> g_next_component_type{0};
+
+// Small dense id per component type, assigned on first use. Indexing arrays by it
+// makes typed component lookup O(1) without hashing a std::type_index.
+template<typename T>
+size_t component_type() {
+    static const size_t id = [] {
+        const size_t next = g_next_component_type.fetch_add(1, std::memory_order_relaxed);
+        if (next >= kMaxComponentTypes) {
+            throw std::runtime_error("Too many component types, cannot register " + std::string(typeid(T).name()));
+        }
+        return next;
+    }();
+    return id;
+}
+
+}
+
+#endif //COMPONENT_TYPE_H
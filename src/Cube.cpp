@@ -2,8 +2,9 @@
 
 #include <vector>
 #include <array>
-#include <GLFW/glfw3.h>
+#include <memory>
 
+#include "MeshComponent.h"
 #include "Vertex.h"
 #include "Transform.h"
 
@@ -45,40 +46,40 @@ const std::array<Vertex, 24> Cube::kUnitCube = {{
     Vertex({-0.5f, 0.5f, -0.5f}, {0.4f, 1.0f, 0.4f, 0.6f}),
 }};
 
-// Implementation of draw method
-void Cube::draw() const {
-    glTranslatef(transform_.position.x, transform_.position.y, transform_.position.z);
-    // this->glRotateF();
-    glScalef(transform_.scale.x, transform_.scale.y, transform_.scale.z);
-
-    glBegin(GL_QUADS);
-    for (const auto& vertex : vertices_) {
-        glColor4f(vertex.r, vertex.g, vertex.b, vertex.a);
-        glVertex3f(vertex.x, vertex.y, vertex.z);
+Cube::Cube(const Transform& transform, const Color& color) : color_(color) {
+    this->transform = transform;
+
+    std::vector<glm::vec3> vertices;
+    std::vector<Color> colors;
+    std::vector<unsigned int> indices;
+    vertices.reserve(kUnitCube.size());
+    colors.reserve(kUnitCube.size());
+    indices.reserve(kUnitCube.size() / 4 * 6);
+    for (const auto& vertex : kUnitCube) {
+        vertices.emplace_back(vertex.x, vertex.y, vertex.z);
+        colors.push_back({vertex.r, vertex.g, vertex.b, vertex.a});
     }
-    glEnd();
-}
-
-void Cube::glRotateF() const {
-    // Convert quaternion to axis-angle representation
-    const auto rotation = this->transform_.rotation;
-    const float angle = glm::degrees(2.0f * std::acos(rotation.w));
-
-    // Avoid division by zero when extracting axis
-    glm::vec3 axis;
-    if (const float s = 1.0f - rotation.w * rotation.w; s > 0.0001f) {
-        axis = glm::vec3(rotation.x, rotation.y, rotation.z) / std::sqrt(s);
-    } else {
-        // Default axis if rotation is near identity
-        axis = glm::vec3(1.0f, 0.0f, 0.0f);
+    // Split each quad into two triangles
+    for (unsigned int quad = 0; quad < kUnitCube.size() / 4; quad++) {
+        const unsigned int first = quad * 4;
+        indices.insert(indices.end(), {first, first + 1, first + 2, first + 2, first + 3, first});
     }
 
-    glRotatef(angle, axis.x, axis.y, axis.z);
+    // Every cube shares the same registered geometry
+    auto mesh = std::make_unique<MeshComponent>(
+        MeshRegistry::shared().get_or_create(std::move(vertices), std::move(indices), std::move(colors)));
+    mesh->color = color;
+    add_component(std::move(mesh));
+}
+
+void Cube::setColor(const Color& color) {
+    color_ = color;
+    get_component<MeshComponent>()->color = color;
 }
 
 void Cube::rotate(const glm::quat& rotation) {
-    const auto newRotation = this->transform_.rotation * rotation;
-    this->transform_.rotation = newRotation;
+    const auto newRotation = this->transform.rotation() * rotation;
+    this->transform.set_rotation(newRotation);
 }
 
 void Cube::rotateX(const float deg) {
@@ -1,31 +1,20 @@
 #ifndef CUBE_H
 #define CUBE_H
 
-#include <vector>
 #include <array>
-#include <ranges>
 
+#include "Color.h"
 #include "GameObject.h"
 #include "Vertex.h"
 #include "Transform.h"
 
-struct Color {
-    float r, g, b, a;
-};
-
 class Cube: public GameObject {
 public:
     explicit Cube(
         const Transform& transform = TRANSFORM_ZERO,
-        const Color& color = kDefaultColor)
-        : vertices_(kUnitCube | std::ranges::to<std::vector>())
-        , transform_(transform)
-        , color_(color) {
-    }
+        const Color& color = kDefaultColor);
 
-    void draw() const;
-
-    void setColor(const Color& color) { color_ = color; }
+    void setColor(const Color& color);
 
     void rotate(const glm::quat&);
     void rotateX(float deg);
@@ -40,10 +29,6 @@ private:
 
     static const std::array<Vertex, 24> kUnitCube;
 
-    void glRotateF() const;
-
-    std::vector<Vertex> vertices_;
-    Transform transform_;
     Color color_;
 };
 
@@ -0,0 +1,105 @@
+#include "EntityRegistry.h"
+
+EntityRegistry::EntityRegistry() {
+    // Archetype 0 holds entities without components
+    auto empty = std::make_unique<Archetype>();
+    empty->column_of.fill(-1);
+    archetypes_.push_back(std::move(empty));
+    archetype_index_[0] = 0;
+}
+
+Entity EntityRegistry::create() {
+    std::uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(records_.size());
+        records_.emplace_back();
+    }
+    Record& record = records_[index];
+    const Entity entity{index, record.generation};
+    Archetype& empty = *archetypes_[0];
+    record.archetype = 0;
+    record.row = static_cast<std::uint32_t>(empty.entities.size());
+    empty.entities.push_back(entity);
+    return entity;
+}
+
+void EntityRegistry::destroy(const Entity entity) {
+    if (!alive(entity)) {
+        return;
+    }
+    Record& record = records_[entity.index];
+    remove_row(*archetypes_[record.archetype], record.row);
+    record.generation++;
+    free_.push_back(entity.index);
+}
+
+bool EntityRegistry::alive(const Entity entity) const {
+    return entity.index < records_.size() && records_[entity.index].generation == entity.generation;
+}
+
+const EntityRegistry::Record& EntityRegistry::checked_record(const Entity entity) const {
+    if (!alive(entity)) {
+        throw std::runtime_error("Entity " + std::to_string(entity.index) + " is not alive");
+    }
+    return records_[entity.index];
+}
+
+size_t EntityRegistry::archetype_with(const std::uint64_t mask, const size_t source, const ColumnFactory extra) {
+    if (const auto it = archetype_index_.find(mask); it != archetype_index_.end()) {
+        return it->second;
+    }
+
+    auto archetype = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    for (const auto& column: archetypes_[source]->columns) {
+        if (mask & bit(column->type)) {
+            archetype->columns.push_back(column->make_empty());
+        }
+    }
+    if (extra) {
+        archetype->columns.push_back(extra());
+    }
+    archetype->column_of.fill(-1);
+    for (size_t i = 0; i < archetype->columns.size(); i++) {
+        archetype->column_of[archetype->columns[i]->type] = static_cast<std::int8_t>(i);
+    }
+
+    const size_t index = archetypes_.size();
+    archetypes_.push_back(std::move(archetype));
+    archetype_index_[mask] = index;
+    return index;
+}
+
+void EntityRegistry::move_entity(const Entity entity, const size_t target) {
+    Record& record = records_[entity.index];
+    Archetype& from = *archetypes_[record.archetype];
+    Archetype& to = *archetypes_[target];
+    const size_t row = record.row;
+
+    for (const auto& column: from.columns) {
+        const std::int8_t destination = to.column_of[column->type];
+        if (destination >= 0) {
+            to.columns[destination]->push_moved(*column, row);
+        }
+    }
+    remove_row(from, row);
+
+    record.archetype = static_cast<std::uint32_t>(target);
+    record.row = static_cast<std::uint32_t>(to.entities.size());
+    to.entities.push_back(entity);
+}
+
+void EntityRegistry::remove_row(Archetype& archetype, const size_t row) {
+    for (const auto& column: archetype.columns) {
+        column->swap_remove(row);
+    }
+    if (row + 1 != archetype.entities.size()) {
+        const Entity moved = archetype.entities.back();
+        archetype.entities[row] = moved;
+        records_[moved.index].row = static_cast<std::uint32_t>(row);
+    }
+    archetype.entities.pop_back();
+}
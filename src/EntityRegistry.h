@@ -0,0 +1,281 @@
+#ifndef ENTITY_REGISTRY_H
+#define ENTITY_REGISTRY_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ComponentType.h"
+
+// Generational handle: a destroyed entity's index is reused with a new
+// generation, so stale handles are detected instead of aliasing the new entity.
+struct Entity {
+    std::uint32_t index{0};
+    std::uint32_t generation{0};
+
+    bool operator==(const Entity&) const = default;
+};
+
+// Archetype-based component storage. Entities with the same set of component
+// types share an archetype, which keeps one contiguous array per component type;
+// an entity is a row across those arrays. Adding or removing a component moves
+// the entity's row to another archetype.
+//
+// get_component<T>() is two array lookups. view<A, B>().each(fn) walks the arrays
+// of every archetype containing A and B linearly, which is what per-frame
+// passes over many entities want.
+//
+// Pointers and references to components are invalidated by any structural
+// change (create, destroy, add or remove a component), including during each().
+// Not thread-safe.
+class EntityRegistry {
+    class Column;
+    template<typename T>
+    class TypedColumn;
+
+public:
+    template<typename... Ts>
+    class View;
+
+    EntityRegistry();
+
+    EntityRegistry(const EntityRegistry&) = delete;
+    EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+    // Creates an entity without components.
+    Entity create();
+
+    // Destroys the entity and its components; stale handles are ignored.
+    void destroy(Entity entity);
+
+    [[nodiscard]]
+    bool alive(Entity entity) const;
+
+    // Live entities.
+    [[nodiscard]]
+    size_t size() const { return records_.size() - free_.size(); }
+
+    [[nodiscard]]
+    size_t archetype_count() const { return archetypes_.size(); }
+
+    // Constructs a T from `args` on the entity. Throws if it already has one.
+    template<typename T, typename... Args>
+    T& add_component(const Entity entity, Args&&... args) {
+        const size_t type = ecs::component_type<T>();
+        const Record& record = checked_record(entity);
+        const std::uint64_t mask = archetypes_[record.archetype]->mask;
+        if (mask & bit(type)) {
+            throw std::runtime_error("Component of type " + std::string(typeid(T).name()) + " already exists");
+        }
+        // Constructed before the move so a throwing constructor leaves the entity intact
+        T component(std::forward<Args>(args)...);
+        const size_t target = archetype_with(mask | bit(type), record.archetype, &TypedColumn<T>::make);
+        move_entity(entity, target);
+
+        Archetype& archetype = *archetypes_[target];
+        auto& column = static_cast<TypedColumn<T>&>(*archetype.columns[archetype.column_of[type]]);
+        return column.data.emplace_back(std::move(component));
+    }
+
+    // Removes the entity's T, if it has one; stale handles are ignored.
+    template<typename T>
+    void remove_component(const Entity entity) {
+        if (!alive(entity)) {
+            return;
+        }
+        const size_t type = ecs::component_type<T>();
+        const Record& record = records_[entity.index];
+        const std::uint64_t mask = archetypes_[record.archetype]->mask;
+        if (mask & bit(type)) {
+            move_entity(entity, archetype_with(mask & ~bit(type), record.archetype, nullptr));
+        }
+    }
+
+    // Returns the entity's T, or nullptr if it has none or is not alive.
+    template<typename T>
+    [[nodiscard]]
+    T* get_component(const Entity entity) {
+        if (!alive(entity)) {
+            return nullptr;
+        }
+        const Record& record = records_[entity.index];
+        Archetype& archetype = *archetypes_[record.archetype];
+        const std::int8_t column = archetype.column_of[ecs::component_type<T>()];
+        if (column < 0) {
+            return nullptr;
+        }
+        return &static_cast<TypedColumn<T>&>(*archetype.columns[column]).data[record.row];
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    const T* get_component(const Entity entity) const {
+        return const_cast<EntityRegistry*>(this)->get_component<T>(entity);
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    bool has_component(const Entity entity) const {
+        return alive(entity) && (archetypes_[records_[entity.index].archetype]->mask & bit(ecs::component_type<T>()));
+    }
+
+    // Entities that have all of Ts.
+    template<typename... Ts>
+    View<Ts...> view() { return View<Ts...>(*this); }
+
+private:
+    // One array of a single component type inside an archetype.
+    class Column {
+    public:
+        virtual ~Column() = default;
+
+        [[nodiscard]]
+        virtual std::unique_ptr<Column> make_empty() const = 0;
+
+        // Appends `source`'s element at `row`, moved out.
+        virtual void push_moved(Column& source, size_t row) = 0;
+
+        // Moves the last element into `row` and shrinks by one.
+        virtual void swap_remove(size_t row) = 0;
+
+        size_t type{0};
+    };
+
+    template<typename T>
+    class TypedColumn final : public Column {
+    public:
+        static std::unique_ptr<Column> make() {
+            auto column = std::make_unique<TypedColumn>();
+            column->type = ecs::component_type<T>();
+            return column;
+        }
+
+        [[nodiscard]]
+        std::unique_ptr<Column> make_empty() const override { return make(); }
+
+        void push_moved(Column& source, const size_t row) override {
+            data.push_back(std::move(static_cast<TypedColumn&>(source).data[row]));
+        }
+
+        void swap_remove(const size_t row) override {
+            if (row + 1 != data.size()) {
+                data[row] = std::move(data.back());
+            }
+            data.pop_back();
+        }
+
+        std::vector<T> data;
+    };
+
+    using ColumnFactory = std::unique_ptr<Column> (*)();
+
+    struct Archetype {
+        std::uint64_t mask{0};
+        std::vector<Entity> entities;
+        std::vector<std::unique_ptr<Column>> columns;
+        // Index into `columns` per component type, -1 when absent
+        std::array<std::int8_t, ecs::kMaxComponentTypes> column_of{};
+    };
+
+    struct Record {
+        std::uint32_t archetype{0};
+        std::uint32_t row{0};
+        std::uint32_t generation{0};
+    };
+
+    static constexpr std::uint64_t bit(const size_t type) { return std::uint64_t{1} << type; }
+
+    // Throws if `entity` is not alive.
+    const Record& checked_record(Entity entity) const;
+
+    // Finds or creates the archetype for `mask`, which is `source`'s mask with one
+    // type added (created by `extra`) or removed (`extra` is null).
+    size_t archetype_with(std::uint64_t mask, size_t source, ColumnFactory extra);
+
+    // Moves the entity's row into `target`, carrying over the components both
+    // archetypes share. A newly added column is left for the caller to append to.
+    void move_entity(Entity entity, size_t target);
+
+    // Removes `row` from `archetype` and patches the record of the entity moved into it.
+    void remove_row(Archetype& archetype, size_t row);
+
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::unordered_map<std::uint64_t, size_t> archetype_index_;
+    std::vector<Record> records_;
+    std::vector<std::uint32_t> free_;
+};
+
+template<typename... Ts>
+class EntityRegistry::View {
+public:
+    explicit View(EntityRegistry& registry) : registry_(registry) {}
+
+    // Calls fn(Entity, Ts&...) for every matching entity, archetype by archetype.
+    template<typename Fn>
+    void each(Fn&& fn) const {
+        const std::uint64_t required = (bit(ecs::component_type<Ts>()) | ... | 0);
+        for (const auto& archetype: registry_.archetypes_) {
+            if ((archetype->mask & required) != required || archetype->entities.empty()) {
+                continue;
+            }
+            each_in(*archetype, fn);
+        }
+    }
+
+    // Calls fn(std::span<const Entity>, std::span<Ts>...) once per matching
+    // archetype, for passes that process whole arrays at a time.
+    template<typename Fn>
+    void each_block(Fn&& fn) const {
+        const std::uint64_t required = (bit(ecs::component_type<Ts>()) | ... | 0);
+        for (const auto& archetype: registry_.archetypes_) {
+            if ((archetype->mask & required) != required || archetype->entities.empty()) {
+                continue;
+            }
+            const size_t count = archetype->entities.size();
+            fn(std::span<const Entity>(archetype->entities), std::span<Ts>(column<Ts>(*archetype), count)...);
+        }
+    }
+
+    // Number of matching entities.
+    [[nodiscard]]
+    size_t size() const {
+        const std::uint64_t required = (bit(ecs::component_type<Ts>()) | ... | 0);
+        size_t count = 0;
+        for (const auto& archetype: registry_.archetypes_) {
+            if ((archetype->mask & required) == required) {
+                count += archetype->entities.size();
+            }
+        }
+        return count;
+    }
+
+private:
+    template<typename Fn>
+    static void each_in(Archetype& archetype, Fn& fn) {
+        const Entity* entities = archetype.entities.data();
+        const size_t count = archetype.entities.size();
+        // Resolve each column once; the loop below is a plain walk over arrays
+        std::tuple<Ts*...> columns{column<Ts>(archetype)...};
+        for (size_t row = 0; row < count; row++) {
+            fn(entities[row], std::get<Ts*>(columns)[row]...);
+        }
+    }
+
+    template<typename T>
+    static T* column(Archetype& archetype) {
+        const std::int8_t index = archetype.column_of[ecs::component_type<T>()];
+        return static_cast<TypedColumn<T>&>(*archetype.columns[index]).data.data();
+    }
+
+    EntityRegistry& registry_;
+};
+
+#endif //ENTITY_REGISTRY_H
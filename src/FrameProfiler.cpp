@@ -0,0 +1,178 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+double milliseconds(const std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::string json_string(const std::string& value) {
+    std::string escaped = "\"";
+    for (const char c: value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        // Control characters have no place in the strings written here
+        escaped += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+    }
+    return escaped + "\"";
+}
+
+void write_summary(std::ostream& out, const char* name, const FrameProfiler::Summary& summary) {
+    out << "    " << json_string(name) << ": {\"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+        << ", \"p90\": " << summary.p90 << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99
+        << ", \"max\": " << summary.max << "}";
+}
+
+std::ofstream create(const std::filesystem::path& path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Failed to create " + path.string());
+    }
+    out << std::fixed << std::setprecision(3);
+    return out;
+}
+
+void close(std::ofstream& out, const std::filesystem::path& path) {
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write " + path.string());
+    }
+}
+}
+
+FrameProfiler::FrameProfiler() {
+    glGenQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+}
+
+FrameProfiler::~FrameProfiler() {
+    glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+}
+
+void FrameProfiler::begin_frame(const float time) {
+    const auto now = Clock::now();
+    if (!frames_.empty()) {
+        frames_.back().frame_ms = milliseconds(now - frame_start_);
+    }
+
+    // Whatever the GPU finished already, then whatever must finish before its
+    // query object is reused for this frame
+    const size_t index = frames_.size();
+    while (collected_ < index && collect(collected_, false)) {
+        collected_++;
+    }
+    while (collected_ + kQueryLatency <= index) {
+        collect(collected_++, true);
+    }
+
+    frames_.push_back({time});
+    frame_start_ = now;
+    glBeginQuery(GL_TIME_ELAPSED, queries_[index % kQueryLatency]);
+}
+
+void FrameProfiler::end_frame(const size_t draw_calls) {
+    glEndQuery(GL_TIME_ELAPSED);
+    Frame& frame = frames_.back();
+    frame.cpu_ms = milliseconds(Clock::now() - frame_start_);
+    frame.draw_calls = draw_calls;
+}
+
+void FrameProfiler::finish() {
+    if (!frames_.empty()) {
+        frames_.back().frame_ms = milliseconds(Clock::now() - frame_start_);
+    }
+    while (collected_ < frames_.size()) {
+        collect(collected_++, true);
+    }
+}
+
+bool FrameProfiler::collect(const size_t index, const bool wait) {
+    const GLuint query = queries_[index % kQueryLatency];
+    if (!wait) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            return false;
+        }
+    }
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+    frames_[index].gpu_ms = static_cast<double>(nanoseconds) / 1e6;
+    return true;
+}
+
+FrameProfiler::Summary FrameProfiler::summarize(std::vector<double> samples) {
+    if (samples.empty()) {
+        return {};
+    }
+    std::ranges::sort(samples);
+    const auto percentile = [&](const double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(samples.size())));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+    return {
+        std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size()),
+        percentile(50.0), percentile(90.0), percentile(95.0), percentile(99.0), samples.back(),
+    };
+}
+
+void FrameProfiler::write_csv(const std::filesystem::path& path) const {
+    std::ofstream out = create(path);
+    out << "frame,time_s,cpu_ms,frame_ms,gpu_ms,draw_calls\n";
+    for (size_t i = 0; i < frames_.size(); i++) {
+        const Frame& frame = frames_[i];
+        out << i << ',' << frame.time << ',' << frame.cpu_ms << ',' << frame.frame_ms << ',';
+        if (frame.gpu_ms >= 0.0) {
+            out << frame.gpu_ms;
+        }
+        out << ',' << frame.draw_calls << '\n';
+    }
+    close(out, path);
+}
+
+void FrameProfiler::write_json(const std::filesystem::path& path,
+                               const std::span<const std::pair<std::string, std::string>> info) const {
+    std::vector<double> cpu;
+    std::vector<double> frame;
+    std::vector<double> gpu;
+    for (const Frame& f: frames_) {
+        cpu.push_back(f.cpu_ms);
+        frame.push_back(f.frame_ms);
+        if (f.gpu_ms >= 0.0) {
+            gpu.push_back(f.gpu_ms);
+        }
+    }
+
+    std::ofstream out = create(path);
+    out << "{\n";
+    for (const auto& [key, value]: info) {
+        out << "  " << json_string(key) << ": " << json_string(value) << ",\n";
+    }
+    out << "  \"frames\": " << frames_.size() << ",\n";
+    out << "  \"summary\": {\n";
+    write_summary(out, "cpu_ms", summarize(cpu));
+    out << ",\n";
+    write_summary(out, "frame_ms", summarize(frame));
+    out << ",\n";
+    write_summary(out, "gpu_ms", summarize(gpu));
+    out << "\n  },\n";
+    out << "  \"per_frame\": [";
+    for (size_t i = 0; i < frames_.size(); i++) {
+        const Frame& f = frames_[i];
+        out << (i > 0 ? ",\n    " : "\n    ") << "{\"time_s\": " << f.time << ", \"cpu_ms\": " << f.cpu_ms
+            << ", \"frame_ms\": " << f.frame_ms << ", \"gpu_ms\": ";
+        if (f.gpu_ms >= 0.0) {
+            out << f.gpu_ms;
+        } else {
+            out << "null";
+        }
+        out << ", \"draw_calls\": " << f.draw_calls << "}";
+    }
+    out << "\n  ]\n}\n";
+    close(out, path);
+}
@@ -0,0 +1,85 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+// Per-frame timings for benchmark runs: CPU time on the render thread, the full
+// frame interval including the buffer swap, and GPU time from timer queries.
+//
+// The GPU time of a frame is read back once the GPU has caught up, at the latest
+// kQueryLatency frames later, so measuring never stalls the pipeline; finish()
+// waits for the last ones.
+//
+// Requires a current OpenGL 3.3 core context for its whole lifetime.
+class FrameProfiler {
+public:
+    struct Frame {
+        // Time along the benchmarked camera path, in seconds
+        float time{0.0f};
+        // From begin_frame() to end_frame()
+        double cpu_ms{0.0};
+        // From begin_frame() to the next frame's begin_frame()
+        double frame_ms{0.0};
+        // Negative while unknown
+        double gpu_ms{-1.0};
+        size_t draw_calls{0};
+    };
+
+    struct Summary {
+        double mean{0.0};
+        double p50{0.0};
+        double p90{0.0};
+        double p95{0.0};
+        double p99{0.0};
+        double max{0.0};
+    };
+
+    static constexpr size_t kQueryLatency = 4;
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    // Starts timing a frame, before any of its CPU work or GL commands.
+    void begin_frame(float time);
+    // Stops timing the frame, after its last GL command and before the buffer swap.
+    void end_frame(size_t draw_calls);
+    // Waits for the outstanding GPU timings. Call once, after the last frame.
+    void finish();
+
+    [[nodiscard]]
+    const std::vector<Frame>& frames() const { return frames_; }
+
+    // Percentiles by nearest rank; all zero for no samples.
+    static Summary summarize(std::vector<double> samples);
+
+    // One row per frame. Throws std::runtime_error if the file cannot be written.
+    void write_csv(const std::filesystem::path& path) const;
+    // The per-frame timings and their summaries, with `info` as string fields of
+    // the top-level object. Throws std::runtime_error if the file cannot be written.
+    void write_json(const std::filesystem::path& path,
+                    std::span<const std::pair<std::string, std::string>> info) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Reads back the query of frame `index`, waiting for it if `wait`; false if it is not ready.
+    bool collect(size_t index, bool wait);
+
+    std::array<GLuint, kQueryLatency> queries_{};
+    std::vector<Frame> frames_;
+    // Frames before this one have their GPU time
+    size_t collected_{0};
+    Clock::time_point frame_start_;
+};
+
+#endif //FRAME_PROFILER_H
@@ -0,0 +1,142 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "Bounds.h"
+
+// The six clip planes of a view-projection matrix, normals pointing inwards.
+struct Frustum {
+    // Left, right, bottom, top, near, far; xyz is the unit normal, w the offset
+    std::array<glm::vec4, 6> planes{};
+
+    // Gribb/Hartmann extraction from the rows of the matrix.
+    static Frustum from(const glm::mat4& view_projection) {
+        const glm::mat4 m = glm::transpose(view_projection);
+        Frustum frustum;
+        frustum.planes = {m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[3] + m[2], m[3] - m[2]};
+        for (glm::vec4& plane: frustum.planes) {
+            plane = plane / glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    [[nodiscard]]
+    bool intersects(const Sphere& sphere) const {
+        for (const glm::vec4& plane: planes) {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Conservative: boxes near a frustum corner may pass without intersecting it.
+    [[nodiscard]]
+    bool intersects(const Aabb& box) const {
+        const glm::vec3 center = box.center();
+        const glm::vec3 extents = box.extents();
+        for (const glm::vec4& plane: planes) {
+            const glm::vec3 normal(plane);
+            if (glm::dot(normal, center) + plane.w < -glm::dot(glm::abs(normal), extents)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Tests many boxes against a frustum at once. Boxes are stored as separate arrays
+// of center and extent components, so the plane tests run over contiguous floats
+// and the compiler vectorizes the loop (SSE/AVX or NEON) without intrinsics.
+class FrustumCuller {
+public:
+    void clear() {
+        count_ = 0;
+        for (auto* values: arrays()) {
+            values->clear();
+        }
+    }
+
+    // Returns the box's index in the cull() output.
+    size_t add(const Aabb& box) {
+        if (count_ == center_x_.size()) {
+            // Arrays always hold whole blocks; the unused lanes stay zero
+            for (auto* values: arrays()) {
+                values->resize(count_ + kLanes, 0.0f);
+            }
+        }
+        const glm::vec3 center = box.center();
+        const glm::vec3 extents = box.extents();
+        center_x_[count_] = center.x;
+        center_y_[count_] = center.y;
+        center_z_[count_] = center.z;
+        extent_x_[count_] = extents.x;
+        extent_y_[count_] = extents.y;
+        extent_z_[count_] = extents.z;
+        return count_++;
+    }
+
+    [[nodiscard]]
+    size_t size() const { return count_; }
+
+    // Sets visible[i] to 1 if box i intersects the frustum and 0 otherwise; returns
+    // the number of visible boxes.
+    size_t cull(const Frustum& frustum, std::vector<std::uint8_t>& visible) const {
+        const size_t padded = center_x_.size();
+        mask_.assign(padded, ~0u);
+
+        const float* __restrict cx = center_x_.data();
+        const float* __restrict cy = center_y_.data();
+        const float* __restrict cz = center_z_.data();
+        const float* __restrict ex = extent_x_.data();
+        const float* __restrict ey = extent_y_.data();
+        const float* __restrict ez = extent_z_.data();
+        // 32-bit lanes, as wide as the floats, so the compare and mask fit one vector
+        std::uint32_t* __restrict mask = mask_.data();
+
+        for (const glm::vec4& plane: frustum.planes) {
+            const float nx = plane.x, ny = plane.y, nz = plane.z, d = plane.w;
+            const float ax = std::abs(nx), ay = std::abs(ny), az = std::abs(nz);
+            // Blocks of kLanes boxes have a fixed trip count, which vectorizes even at -O2
+            for (size_t block = 0; block < padded; block += kLanes) {
+                // Branch-free: each plane clears the masks of the boxes fully outside it
+                for (size_t lane = 0; lane < kLanes; lane++) {
+                    const size_t i = block + lane;
+                    const float distance = nx * cx[i] + ny * cy[i] + nz * cz[i] + d;
+                    const float radius = ax * ex[i] + ay * ey[i] + az * ez[i];
+                    mask[i] &= distance >= -radius ? ~0u : 0u;
+                }
+            }
+        }
+
+        visible.resize(count_);
+        size_t visible_count = 0;
+        for (size_t i = 0; i < count_; i++) {
+            visible[i] = static_cast<std::uint8_t>(mask[i] & 1u);
+            visible_count += visible[i];
+        }
+        return visible_count;
+    }
+
+private:
+    static constexpr size_t kLanes = 8;
+
+    std::array<std::vector<float>*, 6> arrays() {
+        return {&center_x_, &center_y_, &center_z_, &extent_x_, &extent_y_, &extent_z_};
+    }
+
+    size_t count_{0};
+    mutable std::vector<std::uint32_t> mask_;
+    std::vector<float> center_x_;
+    std::vector<float> center_y_;
+    std::vector<float> center_z_;
+    std::vector<float> extent_x_;
+    std::vector<float> extent_y_;
+    std::vector<float> extent_z_;
+};
+
+#endif //FRUSTUM_H
@@ -1,12 +1,15 @@
 #ifndef GAME_OBJECT_H
 #define GAME_OBJECT_H
 
+#include <concepts>
 #include <vector>
-#include <typeindex>
-#include <unordered_map>
-#include <ranges>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
 #include <sstream>
 
+#include "ComponentType.h"
 #include "Transform.h"
 
 class GameObject;
@@ -25,13 +28,47 @@ public:
     Transform transform;
 
     explicit GameObject(std::string name = "GameObject") :
-        name_(std::move(name)),
-        transform(TRANSFORM_ZERO)
+        transform(TRANSFORM_ZERO),
+        name_(std::move(name))
     { }
 
-    ~GameObject() = default;
+    virtual ~GameObject() = default;
 
-    void add_component(std::unique_ptr<Component> component);
+    // Takes ownership of `component`, which must be passed as its concrete type.
+    template<std::derived_from<Component> T>
+    T& add_component(std::unique_ptr<T> component) {
+        if (typeid(*component) != typeid(T)) {
+            throw std::runtime_error("Component of type " + std::string(typeid(*component).name())
+                                     + " must be added as its own type, not " + typeid(T).name());
+        }
+        const size_t type = ecs::component_type<T>();
+        if (type >= components_.size()) {
+            components_.resize(type + 1);
+        }
+        if (components_[type]) {
+            throw std::runtime_error("Component of type " + std::string(typeid(T).name()) + " already exists");
+        }
+        component->game_object = this;
+        components_[type] = std::move(component);
+        return static_cast<T&>(*components_[type]);
+    }
+
+    // Returns the component of exactly type T, or nullptr if this object has none.
+    template<typename T>
+    [[nodiscard]]
+    T* get_component() const {
+        const size_t type = ecs::component_type<T>();
+        return type < components_.size() ? static_cast<T*>(components_[type].get()) : nullptr;
+    }
+
+    // Updates every component, in the order their types were first registered.
+    void update(float delta_time);
+
+    [[nodiscard]]
+    Transform& get_transform() { return transform; }
+
+    [[nodiscard]]
+    const Transform& get_transform() const { return transform; }
 
     [[nodiscard]]
     std::string get_component_names() const;
@@ -42,7 +79,8 @@ public:
     std::string get_name() const;
 
 private:
-    std::unordered_map<std::type_index, std::unique_ptr<Component> > components_;
+    // Indexed by ecs::component_type<T>(); empty slots for types this object lacks
+    std::vector<std::unique_ptr<Component>> components_;
     std::string name_;
 };
 
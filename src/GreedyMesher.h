@@ -0,0 +1,198 @@
+#ifndef GREEDY_MESHER_H
+#define GREEDY_MESHER_H
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Chunk.h"
+#include "ChunkMeshBuilder.h"
+#include "Light.h"
+#include "MeshRegistry.h"
+
+namespace meshing {
+
+// A face of `block` is visible when the block it touches does not hide it.
+// Faces between two blocks of the same transparent material (water) are culled.
+inline bool face_visible(const BlockId block, const BlockId neighbor) {
+    return block != kAir && !is_opaque(neighbor) && block != neighbor;
+}
+
+// Reads a block, treating anything outside the chunk's addressable range
+// (including its padding) as air.
+template<typename ChunkT>
+BlockId sample(const ChunkT& chunk, const glm::ivec3& p) {
+    if constexpr (ChunkT::kPadding > 0) {
+        return chunk.contains_padded(p.x, p.y, p.z) ? chunk.get(p) : kAir;
+    } else {
+        return ChunkT::contains(p.x, p.y, p.z) ? chunk.get(p) : kAir;
+    }
+}
+
+// Ambient occlusion of the corners of a face, in ChunkMeshBuilder::add_quad's
+// order, from opaque(du, dv): 1 if the block at offset (du, dv) from the one in
+// front of the face, along the face's u and v axes, is opaque, else 0. Each corner
+// is darkened by the two blocks along its edges, and by the diagonal one unless
+// both edges already close it off.
+template<typename Opaque>
+std::uint8_t pack_face_ao(Opaque&& opaque) {
+    // (u, v) directions of each corner, origin first
+    constexpr int kCorners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    std::uint8_t ao = 0;
+    for (int i = 0; i < 4; i++) {
+        const int du = kCorners[i][0];
+        const int dv = kCorners[i][1];
+        const int side_u = opaque(du, 0);
+        const int side_v = opaque(0, dv);
+        const int level = side_u && side_v ? 0 : 3 - side_u - side_v - opaque(du, dv);
+        ao |= static_cast<std::uint8_t>(level << (2 * i));
+    }
+    return ao;
+}
+
+// Ambient occlusion of a face on axis `d` looking into the block at `front`.
+template<typename ChunkT>
+std::uint8_t face_ao(const ChunkT& chunk, const glm::ivec3& front, const int d) {
+    glm::ivec3 u{0};
+    glm::ivec3 v{0};
+    u[(d + 1) % 3] = 1;
+    v[(d + 2) % 3] = 1;
+    return pack_face_ao([&](const int du, const int dv) {
+        return is_opaque(sample(chunk, front + du * u + dv * v)) ? 1 : 0;
+    });
+}
+
+// The single level of an AO whose four corners agree, or -1.
+constexpr int uniform_ao(const std::uint8_t ao) {
+    return ao == (ao & 3u) * 0x55u ? ao & 3 : -1;
+}
+
+// Scalar greedy mesher. For each axis it sweeps the planes between block layers,
+// builds a mask of visible faces (culling faces hidden by a solid neighbour) and
+// merges runs of equal faces into the largest rectangles it can, so a flat
+// terrain surface becomes a handful of quads instead of one per block.
+//
+// Faces on the chunk border use the chunk's padding when it has one; otherwise
+// the outside is treated as air.
+//
+// Each face is lit by `light` at the block in front of it and shaded by ambient
+// occlusion at its corners (see face_ao()). Only faces with equal light and an
+// equal AO level on all corners merge; the rest are emitted one per block. Pass
+// NoLight (full sky everywhere) to leave light out of it.
+template<typename ChunkT, typename LightT = NoLight>
+void greedy_mesh(const ChunkT& chunk, ChunkMeshBuilder& builder, const LightT& light = {}) {
+    constexpr int N = ChunkT::kSize;
+    // +key for a face pointing along +d, -key for one pointing along -d, where the
+    // key is the block id with the face's light level and AO level above it
+    std::array<std::int32_t, N * N> mask{};
+    const auto face_key = [](const BlockId block, const light::Level level, const int ao) {
+        return static_cast<std::int32_t>(block) | static_cast<std::int32_t>(level) << 16 | ao << 24;
+    };
+
+    for (int d = 0; d < 3; d++) {
+        const int u = (d + 1) % 3;
+        const int v = (d + 2) % 3;
+        // Plain arrays rather than glm vectors: dynamic component indexing on glm
+        // types defeats register allocation in these inner loops
+        int x[3] = {0, 0, 0};
+        int q[3] = {0, 0, 0};
+        q[d] = 1;
+
+        for (x[d] = -1; x[d] < N;) {
+            // Faces on the plane between layer x[d] and x[d] + 1
+            const bool a_inside = x[d] >= 0;
+            const bool b_inside = x[d] < N - 1;
+            size_t n = 0;
+            for (x[v] = 0; x[v] < N; x[v]++) {
+                for (x[u] = 0; x[u] < N; x[u]++, n++) {
+                    const glm::ivec3 a_pos(x[0], x[1], x[2]);
+                    const glm::ivec3 b_pos(x[0] + q[0], x[1] + q[1], x[2] + q[2]);
+                    const BlockId a = a_inside ? chunk.get(a_pos) : sample(chunk, a_pos);
+                    const BlockId b = b_inside ? chunk.get(b_pos) : sample(chunk, b_pos);
+                    // Each chunk only emits faces of its own blocks
+                    mask[n] = 0;
+                    const bool positive = a_inside && face_visible(a, b);
+                    if (!positive && !(b_inside && face_visible(b, a))) {
+                        continue;
+                    }
+                    const glm::ivec3& front = positive ? b_pos : a_pos;
+                    const BlockId block = positive ? a : b;
+                    const light::Level level = light.get(front.x, front.y, front.z);
+                    const std::uint8_t ao = face_ao(chunk, front, d);
+                    if (const int uniform = uniform_ao(ao); uniform >= 0) {
+                        mask[n] = positive ? face_key(block, level, uniform) : -face_key(block, level, uniform);
+                    } else {
+                        // Shaded unevenly, so it merges with nothing
+                        builder.add_quad(ChunkMeshBuilder::face_of(d, positive), positive ? a_pos : b_pos, 1, 1,
+                                         block, level, ao);
+                    }
+                }
+            }
+            ++x[d];
+
+            n = 0;
+            for (int j = 0; j < N; j++) {
+                for (int i = 0; i < N;) {
+                    const std::int32_t c = mask[n];
+                    if (c == 0) {
+                        i++;
+                        n++;
+                        continue;
+                    }
+
+                    int width = 1;
+                    while (i + width < N && mask[n + width] == c) {
+                        width++;
+                    }
+
+                    int height = 1;
+                    for (; j + height < N; height++) {
+                        bool row_matches = true;
+                        for (int k = 0; k < width; k++) {
+                            if (mask[n + k + height * N] != c) {
+                                row_matches = false;
+                                break;
+                            }
+                        }
+                        if (!row_matches) {
+                            break;
+                        }
+                    }
+
+                    glm::ivec3 origin{0};
+                    // The plane sits at x[d]; positive faces belong to the block below it
+                    origin[d] = c > 0 ? x[d] - 1 : x[d];
+                    origin[u] = i;
+                    origin[v] = j;
+                    const std::int32_t key = std::abs(c);
+                    const auto ao = static_cast<std::uint8_t>((key >> 24) * 0x55);
+                    builder.add_quad(ChunkMeshBuilder::face_of(d, c > 0), origin, width, height,
+                                     static_cast<BlockId>(key & 0xFFFF), static_cast<light::Level>(key >> 16 & 0xFF),
+                                     ao);
+
+                    // Clear the merged rectangle so it is not emitted again
+                    for (int l = 0; l < height; l++) {
+                        for (int k = 0; k < width; k++) {
+                            mask[n + k + l * N] = 0;
+                        }
+                    }
+                    i += width;
+                    n += width;
+                }
+            }
+        }
+    }
+}
+
+template<typename ChunkT, typename LightT = NoLight>
+MeshHandle greedy_mesh(const ChunkT& chunk, const LightT& light = {}) {
+    ChunkMeshBuilder builder;
+    greedy_mesh(chunk, builder, light);
+    return builder.build();
+}
+
+}
+
+#endif //GREEDY_MESHER_H
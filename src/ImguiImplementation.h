@@ -3,10 +3,14 @@
 
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
-#include "backends/imgui_impl_opengl2.h"
+#include "backends/imgui_impl_opengl3.h"
 #include "GLFW/glfw3.h"
 #include "GameObject.h"
 #include "Transform.h"
+#include "ChunkMesher.h"
+#include "ChunkStreamer.h"
+#include "Renderer.h"
+#include "SystemScheduler.h"
 #include <string>
 
 namespace ui {
@@ -22,7 +26,7 @@ namespace ui {
 
         // Setup Platform/Renderer bindings
         ImGui_ImplGlfw_InitForOpenGL(window, true);
-        ImGui_ImplOpenGL2_Init();
+        ImGui_ImplOpenGL3_Init("#version 330 core");
 
         // Setup ImGui style
         ImGui::StyleColorsDark();
@@ -41,7 +45,7 @@ namespace ui {
 
     // Cleanup ImGui resources
     inline void shutdownImGui() {
-        ImGui_ImplOpenGL2_Shutdown();
+        ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
     }
@@ -60,7 +64,7 @@ namespace ui {
         if (window_w > 0 && window_h > 0)
             io.DisplayFramebufferScale = ImVec2((float)display_w / window_w, (float)display_h / window_h);
 
-        ImGui_ImplOpenGL2_NewFrame();
+        ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
     }
@@ -69,7 +73,7 @@ namespace ui {
     inline void render() {
         // Render ImGui
         ImGui::Render();
-        ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
 
     // Display transform information as an overlay
@@ -84,13 +88,13 @@ namespace ui {
 
         if (ImGui::Begin("Camera Transform")) {
             ImGui::Text("Position:");
-            ImGui::Text("  X: %.2f", transform.position.x);
-            ImGui::Text("  Y: %.2f", transform.position.y);
-            ImGui::Text("  Z: %.2f", transform.position.z);
+            ImGui::Text("  X: %.2f", transform.position().x);
+            ImGui::Text("  Y: %.2f", transform.position().y);
+            ImGui::Text("  Z: %.2f", transform.position().z);
 
             ImGui::Separator();
 
-            auto rotation = transform.rotation;
+            auto rotation = transform.rotation();
 
             ImGui::Text("Rotation (Quaternion):");
             ImGui::Text("  W: %.2f", rotation.w);
@@ -110,6 +114,90 @@ namespace ui {
         }
         ImGui::End();
     }
+
+    // Mesher selection for A/B comparison. Returns true when the backend changed.
+    inline bool displayMesherOverlay(meshing::MesherBackend& backend, const double mesh_time_us, const size_t quads) {
+        bool changed = false;
+
+        ImGui::SetNextWindowPos(ImVec2(320, 10), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(0.7f);
+
+        if (ImGui::Begin("Meshing")) {
+            int selected = static_cast<int>(backend);
+            if (ImGui::Combo("Backend", &selected, meshing::kMesherBackendNames.data(),
+                             static_cast<int>(meshing::kMesherBackendNames.size()))) {
+                backend = static_cast<meshing::MesherBackend>(selected);
+                changed = true;
+            }
+            ImGui::Text("Mesh time: %.1f us", mesh_time_us);
+            ImGui::Text("Quads: %zu", quads);
+        }
+        ImGui::End();
+
+        return changed;
+    }
+
+    // Per-frame renderer statistics, with switches to compare culling on and off.
+    inline void displayRendererOverlay(Renderer& renderer, bool& occlusion_culling) {
+        ImGui::SetNextWindowPos(ImVec2(320, 250), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(0.7f);
+
+        if (ImGui::Begin("Renderer")) {
+            bool culling = renderer.culling();
+            if (ImGui::Checkbox("Frustum culling", &culling)) {
+                renderer.set_culling(culling);
+            }
+            ImGui::Checkbox("Occlusion culling", &occlusion_culling);
+            ImGui::Text("Submitted: %zu", renderer.submitted());
+            ImGui::Text("Culled: %zu (%zu occluded)", renderer.culled(), renderer.occluded());
+            ImGui::Text("Instances: %zu", renderer.instances());
+            ImGui::Text("Draw calls: %zu", renderer.draw_calls());
+        }
+        ImGui::End();
+    }
+
+    // Residency, memory use, cave culling and lighting of the chunk streamer.
+    inline void displayStreamingOverlay(ChunkStreamer& streamer) {
+        constexpr double mib = 1024.0 * 1024.0;
+        const auto& config = streamer.config();
+
+        ImGui::SetNextWindowPos(ImVec2(320, 130), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(0.7f);
+
+        if (ImGui::Begin("Streaming")) {
+            ImGui::Text("View radius: %d chunks", config.view_radius);
+            const auto lods = streamer.lod_histogram();
+            ImGui::Text("LOD 0/1/2/3: %zu / %zu / %zu / %zu", lods[0], lods[1], lods[2], lods[3]);
+            ImGui::Text("Resident: %zu (%zu generating)", streamer.resident_chunks(), streamer.generating());
+            ImGui::Text("CPU: %.1f / %.1f MiB", static_cast<double>(streamer.cpu_bytes()) / mib,
+                        static_cast<double>(config.cpu_budget_bytes) / mib);
+            ImGui::Text("GPU: %.1f / %.1f MiB", static_cast<double>(streamer.gpu_bytes()) / mib,
+                        static_cast<double>(config.gpu_budget_bytes) / mib);
+            bool cave_culling = streamer.cave_culling();
+            if (ImGui::Checkbox("Cave culling", &cave_culling)) {
+                streamer.set_cave_culling(cave_culling);
+            }
+            ImGui::Text("Visited: %zu chunks", streamer.visited_chunks());
+            if (const LightEngine* light = streamer.light_engine()) {
+                ImGui::Text("Light: %zu rounds, %zu updates", light->last_rounds(), light->last_updates());
+            }
+        }
+        ImGui::End();
+    }
+
+    // Time spent in the update phase, in total and per system.
+    inline void displaySystemsOverlay(const SystemScheduler& systems) {
+        ImGui::SetNextWindowPos(ImVec2(320, 390), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(0.7f);
+
+        if (ImGui::Begin("Systems")) {
+            ImGui::Text("Update: %.1f us", systems.last_run_us());
+            for (size_t i = 0; i < systems.size(); i++) {
+                ImGui::Text("  %s: %.1f us", systems.name(i).c_str(), systems.time_us(i));
+            }
+        }
+        ImGui::End();
+    }
 }
 
 #endif // IMGUI_IMPLEMENTATION_H
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace {
+// Identifies the worker (if any) running on the current thread.
+thread_local const JobSystem* t_system = nullptr;
+thread_local size_t t_worker_index = 0;
+}
+
+size_t JobSystem::default_worker_count() {
+    const unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+JobSystem::JobSystem(const size_t worker_count) {
+    const size_t count = std::max<size_t>(worker_count, 1);
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // Start threads only once every deque exists, since workers steal from each other
+    for (size_t i = 0; i < count; i++) {
+        workers_[i]->thread = std::thread([this, i] { run(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_.store(true, std::memory_order_release);
+    }
+    wake_.notify_all();
+    for (const auto& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+void JobSystem::submit(Job job, const Priority priority) {
+    const size_t index = t_system == this
+        ? t_worker_index
+        : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+    pending_.fetch_add(1, std::memory_order_acq_rel);
+    {
+        // Count the job before it becomes visible so a thief can never drive the counter
+        // below zero; the lock orders the increment against a worker checking its predicate
+        std::lock_guard lock(sleep_mutex_);
+        queued_.fetch_add(1, std::memory_order_release);
+    }
+    {
+        Worker& worker = *workers_[index];
+        std::lock_guard lock(worker.mutex);
+        worker.queues[static_cast<size_t>(priority)].push_back(std::move(job));
+    }
+    wake_.notify_one();
+}
+
+void JobSystem::wait_idle() {
+    std::unique_lock lock(sleep_mutex_);
+    idle_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+void JobSystem::parallel_for(const size_t count, const std::function<void(size_t)>& fn) {
+    struct Shared {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+    };
+    // Helpers that start after the loop finished only touch this shared state
+    auto shared = std::make_shared<Shared>();
+    const auto* body = &fn;
+    const auto work = [shared, body, count] {
+        for (size_t i = shared->next.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = shared->next.fetch_add(1, std::memory_order_relaxed)) {
+            (*body)(i);
+            shared->done.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    const size_t helpers = std::min(workers_.size(), count > 0 ? count - 1 : 0);
+    for (size_t i = 0; i < helpers; i++) {
+        submit(work, Priority::High);
+    }
+    work();
+    // Iterations claimed by helpers may still be running
+    while (shared->done.load(std::memory_order_acquire) < count) {
+        std::this_thread::yield();
+    }
+}
+
+bool JobSystem::pop_own(const size_t index, const size_t priority, Job& job) {
+    Worker& worker = *workers_[index];
+    std::lock_guard lock(worker.mutex);
+    auto& queue = worker.queues[priority];
+    if (queue.empty()) {
+        return false;
+    }
+    // Front first: keeps the order the submitter chose (e.g. nearest chunk first)
+    job = std::move(queue.front());
+    queue.pop_front();
+    return true;
+}
+
+bool JobSystem::steal(const size_t thief, const size_t priority, Job& job) {
+    for (size_t offset = 1; offset < workers_.size(); offset++) {
+        Worker& victim = *workers_[(thief + offset) % workers_.size()];
+        std::lock_guard lock(victim.mutex);
+        auto& queue = victim.queues[priority];
+        if (queue.empty()) {
+            continue;
+        }
+        // The back holds the victim's least urgent work
+        job = std::move(queue.back());
+        queue.pop_back();
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::find_job(const size_t index, Job& job) {
+    for (size_t priority = 0; priority < kPriorityCount; priority++) {
+        if (pop_own(index, priority, job) || steal(index, priority, job)) {
+            queued_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::run(const size_t index) {
+    t_system = this;
+    t_worker_index = index;
+
+    Job job;
+    while (true) {
+        if (find_job(index, job)) {
+            job();
+            job = nullptr;
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard lock(sleep_mutex_);
+                idle_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex_);
+        wake_.wait(lock, [this] {
+            return stopping_.load(std::memory_order_acquire) || queued_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_.load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads with one deque per worker and work stealing.
+//
+// Jobs submitted from outside the pool are spread round-robin over the workers;
+// jobs submitted from a worker go to its own deque. A worker runs its own jobs
+// in submission order and, when it runs dry, steals from the back of another
+// worker's deque. High priority jobs (e.g. remeshing an edited chunk) are always
+// taken before normal ones.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    enum class Priority : std::uint8_t {
+        High,
+        Normal,
+    };
+
+    // One worker per core, leaving a core for the render thread.
+    static size_t default_worker_count();
+
+    explicit JobSystem(size_t worker_count = default_worker_count());
+
+    // Runs every job still queued, including jobs those submit, then joins the
+    // workers; whatever a queued job refers to must outlive the JobSystem.
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(Job job, Priority priority = Priority::Normal);
+
+    // Blocks until every submitted job has finished. Must not be called from a job.
+    void wait_idle();
+
+    // Calls fn(i) for every i in [0, count) and returns once all calls finished. The
+    // calling thread takes part, and helpers are queued at high priority, so this
+    // does not wait behind unrelated jobs already queued. Safe to call from a job:
+    // the caller runs every iteration no helper has picked up, so it only ever waits
+    // for iterations already running.
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+    [[nodiscard]]
+    size_t worker_count() const { return workers_.size(); }
+
+    // Jobs queued or running.
+    [[nodiscard]]
+    size_t pending() const { return pending_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t kPriorityCount = 2;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> queues[kPriorityCount];
+        std::thread thread;
+    };
+
+    void run(size_t index);
+    bool pop_own(size_t index, size_t priority, Job& job);
+    bool steal(size_t thief, size_t priority, Job& job);
+    bool find_job(size_t index, Job& job);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_worker_{0};
+    // Jobs sitting in a deque, used as the sleep predicate
+    std::atomic<size_t> queued_{0};
+    // Jobs queued or running, used by wait_idle()
+    std::atomic<size_t> pending_{0};
+    std::atomic<bool> stopping_{false};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+};
+
+#endif //JOB_SYSTEM_H
@@ -0,0 +1,40 @@
+#ifndef LIGHT_H
+#define LIGHT_H
+
+#include <cstdint>
+
+#include "Chunk.h"
+
+// Light levels as stored per block and baked into mesh vertices: sky light in the
+// high nibble, block light (from emitters such as lamps) in the low one, each 0 to
+// 15. See LightEngine.h for how they are computed.
+namespace light {
+using Level = std::uint8_t;
+
+constexpr int kMaxLevel = 15;
+
+constexpr Level pack(const int sky, const int block) {
+    return static_cast<Level>(sky << 4 | block);
+}
+
+constexpr int sky(const Level level) { return level >> 4; }
+
+constexpr int block(const Level level) { return level & 15; }
+
+// Open sky, no emitters: what unlit meshes are drawn with.
+constexpr Level kFullSky = pack(kMaxLevel, 0);
+}
+
+using LightChunk = Chunk<kChunkSize, light::Level>;
+
+// Light of a chunk plus a one-block border from its neighbours: every block face
+// of the chunk is lit by the level of the block in front of it, which may lie in
+// a neighbour.
+using LightVolume = Chunk<kChunkSize, light::Level, YMajorLayout, 1>;
+
+// Stands in for a LightVolume when meshing without baked light.
+struct NoLight {
+    static constexpr light::Level get(int, int, int) { return light::kFullSky; }
+};
+
+#endif //LIGHT_H
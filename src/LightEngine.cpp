@@ -0,0 +1,415 @@
+#include "LightEngine.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "Blocks.h"
+
+namespace {
+// Cell index steps along x, y and z in the Y-major layout
+constexpr int kStride[3] = {1, kChunkSize * kChunkSize, kChunkSize};
+
+int floor_div(const int value, const int divisor) {
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+int channel_level(const light::Level level, const bool block_channel) {
+    return block_channel ? light::block(level) : light::sky(level);
+}
+
+// Most light a block can hold: any amount when it is open, only its own emission
+// when it is opaque.
+int capacity(const BlockId block, const bool block_channel) {
+    if (!is_opaque(block)) {
+        return light::kMaxLevel;
+    }
+    return block_channel ? block_emission(block) : 0;
+}
+
+constexpr int coordinate(const std::uint16_t cell, const int axis) {
+    return cell / kStride[axis] % kChunkSize;
+}
+
+constexpr int face_axis(const int face) { return face / 2; }
+
+constexpr bool face_positive(const int face) { return face % 2 == 1; }
+
+struct Step {
+    std::uint16_t cell;
+    // Whether `cell` is in the neighbouring chunk across the face
+    bool crossed;
+};
+
+// The block next to `cell` across `face`; past the chunk's edge, the matching
+// block of the neighbour's opposite layer.
+constexpr Step step(const std::uint16_t cell, const int face) {
+    const int axis = face_axis(face);
+    const int direction = face_positive(face) ? 1 : -1;
+    const int next = coordinate(cell, axis) + direction;
+    if (next >= 0 && next < kChunkSize) {
+        return {static_cast<std::uint16_t>(cell + direction * kStride[axis]), false};
+    }
+    return {static_cast<std::uint16_t>(cell - direction * (kChunkSize - 1) * kStride[axis]), true};
+}
+
+// Cells of the chunk's layer on `face`, and of the neighbour's layer touching it,
+// as fn(inside, outside).
+template<typename Fn>
+void for_each_border_pair(const int face, Fn&& fn) {
+    const int axis = face_axis(face);
+    const int u_axis = (axis + 1) % 3;
+    const int v_axis = (axis + 2) % 3;
+    const int inside_layer = face_positive(face) ? kChunkSize - 1 : 0;
+    const int outside_layer = kChunkSize - 1 - inside_layer;
+    for (int v = 0; v < kChunkSize; v++) {
+        for (int u = 0; u < kChunkSize; u++) {
+            const int base = u * kStride[u_axis] + v * kStride[v_axis];
+            fn(static_cast<std::uint16_t>(base + inside_layer * kStride[axis]),
+               static_cast<std::uint16_t>(base + outside_layer * kStride[axis]));
+        }
+    }
+}
+}
+
+LightEngine::LightEngine(BlockLookup blocks, const int top_chunk_y)
+    : blocks_(std::move(blocks)), top_chunk_y_(top_chunk_y) {
+}
+
+LightEngine::Region* LightEngine::find(const ChunkPos& position) {
+    const auto it = regions_.find(position);
+    return it != regions_.end() ? it->second.get() : nullptr;
+}
+
+const LightEngine::Region* LightEngine::find(const ChunkPos& position) const {
+    const auto it = regions_.find(position);
+    return it != regions_.end() ? it->second.get() : nullptr;
+}
+
+void LightEngine::touch(const ChunkPos& position, Region& region) {
+    if (!region.touched) {
+        region.touched = true;
+        touched_.emplace_back(position, &region);
+    }
+}
+
+void LightEngine::add_chunk(const ChunkPos& position) {
+    auto& slot = regions_[position];
+    if (slot) {
+        return;
+    }
+    slot = std::make_unique<Region>();
+    Region& region = *slot;
+    region.fresh = true;
+    region.changed = true;
+    touch(position, region);
+
+    if (const DenseChunk* blocks = blocks_(position)) {
+        const auto data = blocks->data();
+        for (size_t i = 0; i < LightChunk::kVolume; i++) {
+            if (block_emission(data[i]) > 0) {
+                region.additions.push_back({static_cast<std::uint16_t>(i), 0, kEmit | kBlockChannel});
+            }
+        }
+    }
+    if (position.y == top_chunk_y_) {
+        for (int z = 0; z < N; z++) {
+            for (int x = 0; x < N; x++) {
+                region.additions.push_back({cell_index(x, N - 1, z), light::kMaxLevel, kFromAbove});
+            }
+        }
+    }
+    seed_from_neighbours(position, region);
+}
+
+void LightEngine::seed_from_neighbours(const ChunkPos& position, Region& region) {
+    for (int face = 0; face < 6; face++) {
+        const Region* neighbour = find(position + kFaceNormals[face]);
+        if (!neighbour) {
+            continue;
+        }
+        // Light coming down from the chunk above keeps full sky strength
+        const bool from_above = static_cast<Face>(face) == Face::PosY;
+        const auto levels = neighbour->light.data();
+        for_each_border_pair(face, [&](const std::uint16_t inside, const std::uint16_t outside) {
+            const int sky = light::sky(levels[outside]);
+            const int block = light::block(levels[outside]);
+            const int sky_offer = from_above && sky == light::kMaxLevel ? sky : sky - 1;
+            if (sky_offer > 0) {
+                region.additions.push_back({inside, static_cast<std::uint8_t>(sky_offer),
+                                            from_above ? kFromAbove : std::uint8_t{0}});
+            }
+            if (block > 1) {
+                region.additions.push_back({inside, static_cast<std::uint8_t>(block - 1), kBlockChannel});
+            }
+        });
+    }
+}
+
+void LightEngine::remove_chunk(const ChunkPos& position) {
+    const auto it = regions_.find(position);
+    if (it == regions_.end()) {
+        return;
+    }
+    if (it->second->touched) {
+        std::erase_if(touched_, [&](const auto& entry) { return entry.second == it->second.get(); });
+    }
+    regions_.erase(it);
+}
+
+void LightEngine::block_changed(const glm::ivec3& block) {
+    const ChunkPos position(floor_div(block.x, N), floor_div(block.y, N), floor_div(block.z, N));
+    Region* region = find(position);
+    if (!region) {
+        return;
+    }
+    touch(position, *region);
+    const int x = block.x - position.x * N;
+    const int y = block.y - position.y * N;
+    const int z = block.z - position.z * N;
+    const std::uint16_t cell = cell_index(x, y, z);
+
+    // Darken the block and whatever depended on it, then let the light around it
+    // flow back in; for a block that was dark the removal finds nothing
+    region->removals.push_back({cell, light::kMaxLevel + 1, 0});
+    region->removals.push_back({cell, light::kMaxLevel + 1, kBlockChannel});
+    for (const glm::ivec3& normal: kFaceNormals) {
+        queue_spread(block + normal);
+    }
+    region->additions.push_back({cell, 0, kEmit | kBlockChannel});
+    if (position.y == top_chunk_y_ && y == N - 1) {
+        region->additions.push_back({cell, light::kMaxLevel, kFromAbove});
+    }
+}
+
+void LightEngine::queue_spread(const glm::ivec3& block) {
+    const ChunkPos position(floor_div(block.x, N), floor_div(block.y, N), floor_div(block.z, N));
+    Region* region = find(position);
+    if (!region) {
+        return;
+    }
+    touch(position, *region);
+    const std::uint16_t cell = cell_index(block.x - position.x * N, block.y - position.y * N, block.z - position.z * N);
+    region->additions.push_back({cell, 0, kSpread});
+    region->additions.push_back({cell, 0, kSpread | kBlockChannel});
+}
+
+std::vector<ChunkPos> LightEngine::propagate(JobSystem& jobs) {
+    last_rounds_ = 0;
+    last_updates_ = 0;
+
+    std::vector<std::pair<ChunkPos, Region*>> active;
+    for (const bool removing: {true, false}) {
+        while (true) {
+            active.clear();
+            for (const auto& [position, region]: touched_) {
+                if (!(removing ? region->removals : region->additions).empty()) {
+                    active.emplace_back(position, region);
+                }
+            }
+            if (active.empty()) {
+                break;
+            }
+            for (const auto& [position, region]: active) {
+                region->blocks = blocks_(position);
+            }
+            jobs.parallel_for(active.size(), [&](const size_t i) {
+                const auto& [position, region] = active[i];
+                if (removing) {
+                    run_removals(position, *region);
+                } else {
+                    run_additions(position, *region);
+                }
+            });
+            last_rounds_++;
+
+            // Hand light that left a chunk to its neighbour for the next round
+            for (const auto& [position, region]: active) {
+                for (const Handoff& handoff: region->outbox) {
+                    Region* target = find(handoff.target);
+                    if (!target) {
+                        continue;
+                    }
+                    touch(handoff.target, *target);
+                    (removing ? target->removals : target->additions).push_back(handoff.offer);
+                }
+                region->outbox.clear();
+            }
+        }
+    }
+
+    std::vector<ChunkPos> stale;
+    for (const auto& [position, region]: touched_) {
+        last_updates_ += region->updates;
+        if (region->changed) {
+            stale.push_back(position);
+        }
+        for (int face = 0; face < 6; face++) {
+            const ChunkPos next = position + kFaceNormals[face];
+            const Region* neighbour = find(next);
+            if (!neighbour) {
+                continue;
+            }
+            if ((region->border_changed & 1u << face) != 0
+                || (region->fresh && border_differs(*region, *neighbour, static_cast<Face>(face)))) {
+                stale.push_back(next);
+            }
+        }
+        region->changed = false;
+        region->border_changed = 0;
+        region->fresh = false;
+        region->touched = false;
+        region->updates = 0;
+    }
+    touched_.clear();
+
+    std::ranges::sort(stale, {}, [](const ChunkPos& p) { return std::tuple(p.x, p.y, p.z); });
+    stale.erase(std::ranges::unique(stale).begin(), stale.end());
+    return stale;
+}
+
+void LightEngine::run_removals(const ChunkPos& position, Region& region) const {
+    const auto levels = region.light.data();
+    std::vector<Offer>& queue = region.removals;
+    for (size_t head = 0; head < queue.size(); head++) {
+        const Offer offer = queue[head];
+        const bool block_channel = (offer.flags & kBlockChannel) != 0;
+        const int current = channel_level(levels[offer.cell], block_channel);
+        if (current == 0) {
+            continue;
+        }
+        // Full sky light straight below a darkened block came from it too
+        const bool sky_column = !block_channel && (offer.flags & kFromAbove) != 0
+            && offer.level == light::kMaxLevel && current == light::kMaxLevel;
+        if (current >= offer.level && !sky_column) {
+            // Lit from elsewhere: spreads into the darkened area again afterwards
+            region.additions.push_back({offer.cell, 0, static_cast<std::uint8_t>(kSpread | (offer.flags & kBlockChannel))});
+            continue;
+        }
+        set_level(region, offer.cell, offer.flags, 0);
+        if (block_channel && region.blocks) {
+            // An emitter keeps shining
+            if (const int emission = block_emission(region.blocks->data()[offer.cell]); emission > 0) {
+                region.additions.push_back({offer.cell, static_cast<std::uint8_t>(emission), kBlockChannel});
+            }
+        }
+        for (int face = 0; face < 6; face++) {
+            const bool down = static_cast<Face>(face) == Face::NegY;
+            const auto flags = static_cast<std::uint8_t>((offer.flags & kBlockChannel) | (down ? kFromAbove : 0));
+            const auto [cell, crossed] = step(offer.cell, face);
+            if (crossed) {
+                region.outbox.push_back({position + kFaceNormals[face], {cell, static_cast<std::uint8_t>(current), flags}});
+            } else if (channel_level(levels[cell], block_channel) != 0) {
+                queue.push_back({cell, static_cast<std::uint8_t>(current), flags});
+            }
+        }
+    }
+    queue.clear();
+}
+
+void LightEngine::run_additions(const ChunkPos& position, Region& region) const {
+    const auto levels = region.light.data();
+    std::vector<Offer>& queue = region.additions;
+    for (size_t head = 0; head < queue.size(); head++) {
+        Offer offer = queue[head];
+        if ((offer.flags & kEmit) != 0) {
+            const BlockId block = region.blocks ? region.blocks->data()[offer.cell] : kAir;
+            offer.level = static_cast<std::uint8_t>(block_emission(block));
+            if (offer.level == 0) {
+                continue;
+            }
+        }
+        const bool block_channel = (offer.flags & kBlockChannel) != 0;
+        const int current = channel_level(levels[offer.cell], block_channel);
+        int level = current;
+        if ((offer.flags & kSpread) == 0) {
+            const BlockId block = region.blocks ? region.blocks->data()[offer.cell] : kAir;
+            level = std::min<int>(offer.level, capacity(block, block_channel));
+            if (level <= current) {
+                continue;
+            }
+            set_level(region, offer.cell, offer.flags, level);
+        }
+        for (int face = 0; face < 6; face++) {
+            const bool down = static_cast<Face>(face) == Face::NegY;
+            const int next = !block_channel && down && level == light::kMaxLevel ? level : level - 1;
+            if (next <= 0) {
+                continue;
+            }
+            const auto flags = static_cast<std::uint8_t>((offer.flags & kBlockChannel) | (down ? kFromAbove : 0));
+            const auto [cell, crossed] = step(offer.cell, face);
+            if (crossed) {
+                region.outbox.push_back({position + kFaceNormals[face], {cell, static_cast<std::uint8_t>(next), flags}});
+            } else if (channel_level(levels[cell], block_channel) < next) {
+                // Already as bright is the common case inside a lit area
+                queue.push_back({cell, static_cast<std::uint8_t>(next), flags});
+            }
+        }
+    }
+    queue.clear();
+}
+
+void LightEngine::set_level(Region& region, const std::uint16_t cell, const std::uint8_t flags, const int level) {
+    light::Level& value = region.light.data()[cell];
+    value = (flags & kBlockChannel) != 0 ? light::pack(light::sky(value), level) : light::pack(level, light::block(value));
+    region.changed = true;
+    region.updates++;
+    for (int axis = 0; axis < 3; axis++) {
+        const int c = coordinate(cell, axis);
+        if (c == 0) {
+            region.border_changed |= static_cast<std::uint8_t>(1u << (axis * 2));
+        } else if (c == N - 1) {
+            region.border_changed |= static_cast<std::uint8_t>(1u << (axis * 2 + 1));
+        }
+    }
+}
+
+bool LightEngine::border_differs(const Region& region, const Region& neighbour, const Face face) {
+    const auto inside = region.light.data();
+    const auto outside = neighbour.light.data();
+    bool differs = false;
+    for_each_border_pair(static_cast<int>(face), [&](const std::uint16_t a, const std::uint16_t b) {
+        differs |= inside[a] != outside[b];
+    });
+    return differs;
+}
+
+light::Level LightEngine::get(const glm::ivec3& block) const {
+    const ChunkPos position(floor_div(block.x, N), floor_div(block.y, N), floor_div(block.z, N));
+    const Region* region = find(position);
+    if (!region) {
+        return 0;
+    }
+    return region->light.get(block.x - position.x * N, block.y - position.y * N, block.z - position.z * N);
+}
+
+void LightEngine::fill_volume(const ChunkPos& position, LightVolume& volume) const {
+    const Region* region = find(position);
+    if (!region) {
+        volume.fill(light::kFullSky);
+        return;
+    }
+    for (int y = 0; y < N; y++) {
+        for (int z = 0; z < N; z++) {
+            const auto source = region->light.row(y, z);
+            std::ranges::copy(source, volume.row(y, z).begin() + 1);
+        }
+    }
+    for (int face = 0; face < 6; face++) {
+        if (const Region* neighbour = find(position + kFaceNormals[face])) {
+            volume.copy_padding_from(neighbour->light, static_cast<Face>(face));
+        } else if (static_cast<Face>(face) == Face::PosY && position.y == top_chunk_y_) {
+            volume.fill_padding(Face::PosY, light::kFullSky);
+        } else {
+            // What the neighbour will most likely hold once it loads
+            const int axis = face_axis(face);
+            const int outside = face_positive(face) ? N : -1;
+            const auto levels = region->light.data();
+            for_each_border_pair(face, [&](const std::uint16_t inside, std::uint16_t) {
+                int p[3] = {coordinate(inside, 0), coordinate(inside, 1), coordinate(inside, 2)};
+                p[axis] = outside;
+                volume.set(p[0], p[1], p[2], levels[inside]);
+            });
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef LIGHT_ENGINE_H
+#define LIGHT_ENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Chunk.h"
+#include "JobSystem.h"
+#include "Light.h"
+
+// Sky light and block light for the loaded chunks, spread by breadth-first flood
+// fill. Sky light enters the top layer of the world at full strength and keeps it
+// straight down through open blocks; both kinds lose one level per step otherwise.
+// Opaque blocks stop light, except that an emitter holds its own level.
+//
+// Work is queued as offers to individual blocks: removals first (everything that
+// depended on a darkened block is zeroed, and the lit blocks bordering that area
+// are queued to spread again), then additions. Only the chunks that have offers
+// take part, so relighting after an edit costs what the edit affects, not what is
+// loaded. propagate() runs the chunks in rounds, in parallel: each chunk floods
+// its own blocks, and light leaving it is handed to the neighbour for the next
+// round.
+//
+// Not thread-safe: driven by one thread at a time, normally the render thread.
+class LightEngine {
+public:
+    // Blocks of a loaded chunk, or nullptr when it is all air. Only called from the
+    // thread driving the engine.
+    using BlockLookup = std::function<const DenseChunk*(const ChunkPos&)>;
+
+    // Chunks at `top_chunk_y` are lit by open sky from above.
+    LightEngine(BlockLookup blocks, int top_chunk_y);
+
+    LightEngine(const LightEngine&) = delete;
+    LightEngine& operator=(const LightEngine&) = delete;
+
+    // Starts lighting a chunk that was just loaded: its emitters, the sky above it
+    // and the light of loaded neighbours flowing in. Takes effect at propagate().
+    void add_chunk(const ChunkPos& position);
+
+    // Forgets a chunk's light. What it passed on to its neighbours stays.
+    void remove_chunk(const ChunkPos& position);
+
+    // Relights around a block whose value the lookup now returns differently (in
+    // block coordinates: chunk p spans p * kChunkSize to (p + 1) * kChunkSize).
+    // Takes effect at propagate(), which reads the block's value then, so the block
+    // may change any number of times in between.
+    void block_changed(const glm::ivec3& block);
+
+    // Runs the queued removals, then the queued additions, to completion, spread
+    // over `jobs`. Returns the chunks whose meshes no longer match the light: those
+    // whose light changed, and neighbours of changes on their border.
+    std::vector<ChunkPos> propagate(JobSystem& jobs);
+
+    // Light at `block`; 0 where nothing is loaded.
+    [[nodiscard]]
+    light::Level get(const glm::ivec3& block) const;
+
+    // Copies a loaded chunk's light and its border with the neighbours, for
+    // meshing. Borders without a loaded neighbour repeat the chunk's own edge,
+    // except for open sky above the top of the world.
+    void fill_volume(const ChunkPos& position, LightVolume& volume) const;
+
+    [[nodiscard]]
+    bool contains(const ChunkPos& position) const { return regions_.contains(position); }
+
+    [[nodiscard]]
+    size_t chunk_count() const { return regions_.size(); }
+
+    // Rounds and block light changes of the latest propagate().
+    [[nodiscard]]
+    size_t last_rounds() const { return last_rounds_; }
+
+    [[nodiscard]]
+    size_t last_updates() const { return last_updates_; }
+
+private:
+    static constexpr int N = kChunkSize;
+    static_assert(LightChunk::kVolume <= 65536, "Cells are indexed with 16 bits");
+
+    // Offer flags
+    static constexpr std::uint8_t kBlockChannel = 1;
+    // Arrived from the block above: sky light keeps full strength going down
+    static constexpr std::uint8_t kFromAbove = 2;
+    // Spread the block's current level instead of raising it
+    static constexpr std::uint8_t kSpread = 4;
+    // Raise the block to its own emission, looked up when the offer runs: the block
+    // may change again between queuing the offer and propagate()
+    static constexpr std::uint8_t kEmit = 8;
+
+    struct Offer {
+        std::uint16_t cell;
+        std::uint8_t level;
+        std::uint8_t flags;
+    };
+
+    struct Handoff {
+        ChunkPos target;
+        Offer offer;
+    };
+
+    struct Region {
+        LightChunk light;
+        // Refreshed before every round: edits publish new block snapshots
+        const DenseChunk* blocks{nullptr};
+        std::vector<Offer> removals;
+        std::vector<Offer> additions;
+        std::vector<Handoff> outbox;
+        bool changed{false};
+        // Faces (bit per Face) with a border block whose light changed
+        std::uint8_t border_changed{0};
+        bool fresh{false};
+        bool touched{false};
+        size_t updates{0};
+    };
+
+    static constexpr std::uint16_t cell_index(const int x, const int y, const int z) {
+        return static_cast<std::uint16_t>(LightChunk::index(x, y, z));
+    }
+
+    [[nodiscard]]
+    Region* find(const ChunkPos& position);
+    [[nodiscard]]
+    const Region* find(const ChunkPos& position) const;
+    void touch(const ChunkPos& position, Region& region);
+
+    // Queues offers into `region` from the light of its loaded neighbours' border blocks.
+    void seed_from_neighbours(const ChunkPos& position, Region& region);
+    // Queues the block to spread its light again, if it is loaded.
+    void queue_spread(const glm::ivec3& block);
+
+    void run_removals(const ChunkPos& position, Region& region) const;
+    void run_additions(const ChunkPos& position, Region& region) const;
+    static void set_level(Region& region, std::uint16_t cell, std::uint8_t flags, int level);
+    // Whether `neighbour`'s mesh, built while `region` was missing, read different
+    // light on the border between them than `region` now holds.
+    static bool border_differs(const Region& region, const Region& neighbour, Face face);
+
+    BlockLookup blocks_;
+    int top_chunk_y_;
+    std::unordered_map<ChunkPos, std::unique_ptr<Region>, ChunkPosHash> regions_;
+    // Regions queued or changed since the last propagate()
+    std::vector<std::pair<ChunkPos, Region*>> touched_;
+
+    size_t last_rounds_{0};
+    size_t last_updates_{0};
+};
+
+#endif //LIGHT_ENGINE_H
@@ -1,20 +1,29 @@
 
 #ifndef MESHCOMPONENT_H
 #define MESHCOMPONENT_H
+#include <utility>
+#include <vector>
+
+#include "glm/vec3.hpp"
 #include "Color.h"
 #include "GameObject.h"
+#include "MeshRegistry.h"
 
 
+// Refers to shared, immutable geometry. To change the shape of an object, assign
+// a different handle; the renderer uploads each distinct MeshData once.
 class MeshComponent final : public Component {
 public:
-    std::vector<glm::vec3> vertices;
-    std::vector<unsigned int> indices;
+    MeshHandle mesh;
     Color color;
 
+    explicit MeshComponent(MeshHandle mesh) :
+        mesh(std::move(mesh)), color({1.0f, 0.0f, 0.0f, 0.7f}) {}
+
     MeshComponent(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices) :
-        vertices(vertices), indices(indices), color({1.0f, 0.0f, 0.0f, 0.7f}) {}
+        MeshComponent(MeshRegistry::shared().get_or_create(vertices, indices)) {}
 
-    MeshComponent() = default;
+    MeshComponent() : color({1.0f, 0.0f, 0.0f, 0.7f}) {}
 };
 
 #endif //MESHCOMPONENT_H
@@ -0,0 +1,327 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "glm/geometric.hpp"
+
+namespace mesh_optimizer {
+namespace {
+// Scoring parameters from Forsyth, "Linear-Speed Vertex Cache Optimisation". The
+// scoring cache is larger than the simulated one so vertices fade out gradually.
+constexpr size_t kScoringCacheSize = 32;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+// Valences above this share the last table entry; their boost is negligible
+constexpr size_t kMaxScoredValence = 64;
+
+// Clusters are never cut shorter than this, so the sort has something to gain.
+constexpr size_t kMinClusterTriangles = 16;
+
+struct ScoreTables {
+    std::array<float, kScoringCacheSize> cache{};
+    std::array<float, kMaxScoredValence + 1> valence{};
+
+    ScoreTables() {
+        for (size_t i = 0; i < cache.size(); i++) {
+            // The last triangle's vertices score the same regardless of their order
+            cache[i] = i < 3
+                ? kLastTriangleScore
+                : std::pow(1.0f - static_cast<float>(i - 3) / static_cast<float>(kScoringCacheSize - 3), kCacheDecayPower);
+        }
+        valence[0] = 0.0f;
+        for (size_t i = 1; i < valence.size(); i++) {
+            // Favors finishing off vertices with few triangles left
+            valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+        }
+    }
+
+    [[nodiscard]]
+    float score(const int cache_position, const unsigned int remaining) const {
+        if (remaining == 0) {
+            return -1.0f;
+        }
+        const float boost = valence[std::min<size_t>(remaining, kMaxScoredValence)];
+        return cache_position < 0 ? boost : boost + cache[cache_position];
+    }
+};
+
+void check_triangles(const std::span<const unsigned int> indices, const size_t vertex_count) {
+    if (indices.size() % 3 != 0) {
+        throw std::runtime_error("Index count is not a multiple of 3");
+    }
+    for (const unsigned int index: indices) {
+        if (index >= vertex_count) {
+            throw std::runtime_error("Index out of range: " + std::to_string(index));
+        }
+    }
+}
+}
+
+CacheStats analyze(const std::span<const unsigned int> indices, const size_t vertex_count, const size_t cache_size) {
+    check_triangles(indices, vertex_count);
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return {};
+    }
+
+    // A vertex is cached while fewer than cache_size misses happened since its own;
+    // timestamp 0 means never transformed
+    std::vector<size_t> timestamp(vertex_count, 0);
+    size_t time = cache_size + 1;
+    size_t misses = 0;
+    size_t referenced = 0;
+    for (const unsigned int index: indices) {
+        if (timestamp[index] == 0) {
+            ++referenced;
+        } else if (time - timestamp[index] <= cache_size) {
+            continue;
+        }
+        timestamp[index] = time++;
+        ++misses;
+    }
+    return {
+        static_cast<double>(misses) / static_cast<double>(triangle_count),
+        static_cast<double>(misses) / static_cast<double>(referenced),
+    };
+}
+
+void optimize_vertex_cache(const std::span<unsigned int> indices, const size_t vertex_count) {
+    check_triangles(indices, vertex_count);
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count < 2) {
+        return;
+    }
+    static const ScoreTables tables;
+
+    // Triangles using each vertex, packed per vertex; the first remaining[v]
+    // entries of a vertex's range are the ones not emitted yet
+    std::vector<unsigned int> remaining(vertex_count, 0);
+    for (const unsigned int index: indices) {
+        remaining[index]++;
+    }
+    std::vector<size_t> offsets(vertex_count + 1, 0);
+    std::partial_sum(remaining.begin(), remaining.end(), offsets.begin() + 1);
+    std::vector<unsigned int> adjacency(indices.size());
+    {
+        std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+
+    std::vector<float> score(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++) {
+        score[v] = tables.score(-1, remaining[v]);
+    }
+
+    std::vector<std::uint8_t> emitted(triangle_count, 0);
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> next_cache;
+    cache.reserve(kScoringCacheSize + 3);
+    next_cache.reserve(kScoringCacheSize + 3);
+
+    size_t cursor = 0;
+    size_t best = std::numeric_limits<size_t>::max();
+    while (output.size() < indices.size()) {
+        if (best == std::numeric_limits<size_t>::max()) {
+            // No cached vertex has triangles left: continue in input order
+            while (emitted[cursor]) {
+                ++cursor;
+            }
+            best = cursor;
+        }
+
+        const unsigned int* triangle = &indices[best * 3];
+        emitted[best] = 1;
+        next_cache.clear();
+        for (int k = 0; k < 3; k++) {
+            const unsigned int v = triangle[k];
+            output.push_back(v);
+            // Degenerate triangles list the vertex, and appear in its range, more than once
+            const auto begin = adjacency.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+            const auto end = begin + remaining[v];
+            *std::find(begin, end, static_cast<unsigned int>(best)) = *(end - 1);
+            remaining[v]--;
+            if (std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end()) {
+                next_cache.push_back(v);
+            }
+        }
+        for (const unsigned int v: cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                next_cache.push_back(v);
+            }
+        }
+        for (size_t i = kScoringCacheSize; i < next_cache.size(); i++) {
+            const unsigned int v = next_cache[i];
+            score[v] = tables.score(-1, remaining[v]);
+        }
+        next_cache.resize(std::min(next_cache.size(), kScoringCacheSize));
+        std::swap(cache, next_cache);
+
+        for (size_t i = 0; i < cache.size(); i++) {
+            const unsigned int v = cache[i];
+            score[v] = tables.score(static_cast<int>(i), remaining[v]);
+        }
+
+        // Only triangles touching the cache can have changed enough to win
+        best = std::numeric_limits<size_t>::max();
+        float best_score = -1.0f;
+        for (const unsigned int v: cache) {
+            const size_t begin = offsets[v];
+            for (size_t i = begin; i < begin + remaining[v]; i++) {
+                const unsigned int t = adjacency[i];
+                const float candidate = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+                if (candidate > best_score) {
+                    best_score = candidate;
+                    best = t;
+                }
+            }
+        }
+    }
+    std::ranges::copy(output, indices.begin());
+}
+
+void optimize_overdraw(const std::span<unsigned int> indices, const std::span<const glm::vec3> positions,
+                       const float threshold) {
+    check_triangles(indices, positions.size());
+    const size_t triangle_count = indices.size() / 3;
+    if (triangle_count < 2 * kMinClusterTriangles) {
+        return;
+    }
+
+    // Cut the list where the cluster so far, drawn from a cold cache, is still
+    // within `threshold` of the whole list's ACMR. Every closed cluster then is,
+    // so reordering them costs at most about that much.
+    const double target = analyze(indices, positions.size()).acmr * threshold;
+    std::vector<size_t> starts{0};
+    {
+        std::vector<size_t> timestamp(positions.size(), 0);
+        size_t time = kCacheSize + 1;
+        size_t misses = 0;
+        for (size_t t = 0; t < triangle_count; t++) {
+            for (int k = 0; k < 3; k++) {
+                const unsigned int v = indices[t * 3 + k];
+                if (timestamp[v] == 0 || time - timestamp[v] > kCacheSize) {
+                    timestamp[v] = time++;
+                    ++misses;
+                }
+            }
+            const size_t length = t + 1 - starts.back();
+            if (length >= kMinClusterTriangles && t + 1 < triangle_count
+                && static_cast<double>(misses) <= target * static_cast<double>(length)) {
+                starts.push_back(t + 1);
+                misses = 0;
+                // Flush the cache so the next cluster is measured cold
+                time += kCacheSize + 1;
+            }
+        }
+    }
+    if (starts.size() < 2) {
+        return;
+    }
+    starts.push_back(triangle_count);
+    const size_t cluster_count = starts.size() - 1;
+
+    // Area-weighted centroid and summed normal of each cluster
+    std::vector<glm::vec3> centroids(cluster_count, glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(cluster_count, glm::vec3(0.0f));
+    std::vector<float> areas(cluster_count, 0.0f);
+    glm::vec3 mesh_centroid(0.0f);
+    float mesh_area = 0.0f;
+    for (size_t c = 0; c < cluster_count; c++) {
+        for (size_t t = starts[c]; t < starts[c + 1]; t++) {
+            const glm::vec3& a = positions[indices[t * 3]];
+            const glm::vec3& b = positions[indices[t * 3 + 1]];
+            const glm::vec3& d = positions[indices[t * 3 + 2]];
+            const glm::vec3 normal = glm::cross(b - a, d - a);
+            const float area = glm::length(normal);
+            centroids[c] += (a + b + d) * (area / 3.0f);
+            normals[c] += normal;
+            areas[c] += area;
+        }
+        mesh_centroid += centroids[c];
+        mesh_area += areas[c];
+        if (areas[c] > 0.0f) {
+            centroids[c] /= areas[c];
+        }
+    }
+    if (mesh_area > 0.0f) {
+        mesh_centroid /= mesh_area;
+    }
+
+    // Clusters facing away from the middle of the mesh are likely in front of the
+    // rest of it from wherever they are visible, so drawing them first lets depth
+    // testing reject more of what follows
+    std::vector<float> keys(cluster_count, 0.0f);
+    for (size_t c = 0; c < cluster_count; c++) {
+        const float length = glm::length(normals[c]);
+        if (length > 0.0f) {
+            keys[c] = glm::dot(centroids[c] - mesh_centroid, normals[c] / length);
+        }
+    }
+    std::vector<size_t> order(cluster_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [&](const size_t a, const size_t b) { return keys[a] > keys[b]; });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (const size_t c: order) {
+        output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(starts[c] * 3),
+                      indices.begin() + static_cast<std::ptrdiff_t>(starts[c + 1] * 3));
+    }
+    std::ranges::copy(output, indices.begin());
+}
+
+void optimize_vertex_fetch(std::vector<glm::vec3>& vertices, std::vector<Color>& colors,
+                           const std::span<unsigned int> indices) {
+    if (!colors.empty() && colors.size() != vertices.size()) {
+        throw std::runtime_error("Vertex colors do not match the vertex count");
+    }
+    check_triangles(indices, vertices.size());
+
+    constexpr unsigned int kUnused = std::numeric_limits<unsigned int>::max();
+    std::vector<unsigned int> remap(vertices.size(), kUnused);
+    unsigned int next = 0;
+    for (unsigned int& index: indices) {
+        if (remap[index] == kUnused) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+
+    std::vector<glm::vec3> reordered(next);
+    std::vector<Color> reordered_colors(colors.empty() ? 0 : next);
+    for (size_t v = 0; v < vertices.size(); v++) {
+        if (remap[v] == kUnused) {
+            continue;
+        }
+        reordered[remap[v]] = vertices[v];
+        if (!colors.empty()) {
+            reordered_colors[remap[v]] = colors[v];
+        }
+    }
+    vertices = std::move(reordered);
+    colors = std::move(reordered_colors);
+}
+
+Report optimize(std::vector<glm::vec3>& vertices, std::vector<unsigned int>& indices, std::vector<Color>& colors) {
+    Report report;
+    report.before = analyze(indices, vertices.size());
+    optimize_vertex_cache(indices, vertices.size());
+    optimize_overdraw(indices, vertices);
+    optimize_vertex_fetch(vertices, colors, indices);
+    report.after = analyze(indices, vertices.size());
+    return report;
+}
+}
@@ -0,0 +1,118 @@
+#include "MeshRegistry.h"
+
+#include <algorithm>
+
+namespace {
+// FNV-1a over the raw bytes of a buffer, chained through `hash`.
+template<typename T>
+std::uint64_t hash_bytes(const std::vector<T>& values, std::uint64_t hash) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(values.data());
+    const size_t size = values.size() * sizeof(T);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    // Mix in the element count so buffers of different lengths cannot collide trivially
+    hash ^= values.size();
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+bool same_colors(const std::vector<Color>& a, const std::vector<Color>& b) {
+    return std::ranges::equal(a, b, [](const Color& x, const Color& y) {
+        return x.r == y.r && x.g == y.g && x.b == y.b && x.a == y.a;
+    });
+}
+}
+
+MeshRegistry& MeshRegistry::shared() {
+    static MeshRegistry registry;
+    return registry;
+}
+
+std::uint64_t MeshRegistry::content_hash(const std::vector<glm::vec3>& vertices,
+                                         const std::vector<unsigned int>& indices,
+                                         const std::vector<Color>& colors) {
+    std::uint64_t hash = 14695981039346656037ull;
+    hash = hash_bytes(vertices, hash);
+    hash = hash_bytes(indices, hash);
+    hash = hash_bytes(colors, hash);
+    return hash;
+}
+
+MeshHandle MeshRegistry::get_or_create(std::vector<glm::vec3> vertices,
+                                       std::vector<unsigned int> indices,
+                                       std::vector<Color> colors) {
+    const std::uint64_t hash = content_hash(vertices, indices, colors);
+
+    std::lock_guard lock(mutex_);
+    auto [first, last] = meshes_.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        MeshHandle existing = it->second.lock();
+        // Compare the contents too so a hash collision never aliases two meshes
+        if (existing
+            && existing->vertices == vertices
+            && existing->indices == indices
+            && same_colors(existing->colors, colors)) {
+            return existing;
+        }
+    }
+
+    const Aabb bounds = Aabb::of(vertices);
+    auto mesh = std::make_shared<const MeshData>(MeshData{
+        std::move(vertices), std::move(indices), std::move(colors), hash, bounds, {}
+    });
+    meshes_.emplace(hash, mesh);
+
+    if (++inserts_since_prune_ >= meshes_.size() / 2) {
+        prune_expired();
+    }
+    return mesh;
+}
+
+MeshHandle MeshRegistry::get_or_create_optimized(std::vector<glm::vec3> vertices,
+                                                 std::vector<unsigned int> indices,
+                                                 std::vector<Color> colors,
+                                                 mesh_optimizer::Report* report) {
+    const mesh_optimizer::Report result = mesh_optimizer::optimize(vertices, indices, colors);
+    if (report != nullptr) {
+        *report = result;
+    }
+    return get_or_create(std::move(vertices), std::move(indices), std::move(colors));
+}
+
+MeshHandle MeshRegistry::create_unique(std::vector<glm::vec3> vertices,
+                                       std::vector<unsigned int> indices,
+                                       std::vector<Color> colors) {
+    const Aabb bounds = Aabb::of(vertices);
+    return std::make_shared<const MeshData>(MeshData{
+        std::move(vertices), std::move(indices), std::move(colors), 0, bounds, {}
+    });
+}
+
+MeshHandle MeshRegistry::create_packed(std::vector<PackedVertex> vertices, std::vector<unsigned int> indices) {
+    Aabb bounds;
+    if (!vertices.empty()) {
+        glm::ivec3 low = vertices.front().local_position();
+        glm::ivec3 high = low;
+        for (const PackedVertex& vertex: vertices) {
+            low = glm::min(low, vertex.local_position());
+            high = glm::max(high, vertex.local_position());
+        }
+        bounds = {glm::vec3(low), glm::vec3(high)};
+    }
+    return std::make_shared<const MeshData>(MeshData{
+        {}, std::move(indices), {}, 0, bounds, std::move(vertices)
+    });
+}
+
+size_t MeshRegistry::size() {
+    std::lock_guard lock(mutex_);
+    prune_expired();
+    return meshes_.size();
+}
+
+void MeshRegistry::prune_expired() {
+    std::erase_if(meshes_, [](const auto& entry) { return entry.second.expired(); });
+    inserts_since_prune_ = 0;
+}
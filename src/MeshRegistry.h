@@ -0,0 +1,84 @@
+#ifndef MESH_REGISTRY_H
+#define MESH_REGISTRY_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Bounds.h"
+#include "Color.h"
+#include "MeshOptimizer.h"
+#include "PackedVertex.h"
+
+// Immutable geometry shared between every MeshComponent that uses it.
+struct MeshData {
+    std::vector<glm::vec3> vertices;
+    std::vector<unsigned int> indices;
+    // Optional per-vertex colors; when empty the mesh is drawn with the component color.
+    std::vector<Color> colors;
+    std::uint64_t hash{0};
+    // Local-space bounds of the vertices
+    Aabb bounds;
+    // Voxel meshes store their vertices here instead; `vertices` and `colors` are then empty.
+    std::vector<PackedVertex> packed;
+
+    [[nodiscard]]
+    size_t vertex_count() const { return packed.empty() ? vertices.size() : packed.size(); }
+};
+
+using MeshHandle = std::shared_ptr<const MeshData>;
+
+// Deduplicates mesh geometry by content. Handles are reference counted: the
+// geometry is freed once the last handle goes away, and the registry only keeps
+// weak references, so memory for repeated geometry is O(unique meshes).
+//
+// Thread-safe.
+class MeshRegistry {
+public:
+    // Process-wide registry used by components that are not given one explicitly.
+    static MeshRegistry& shared();
+
+    // Returns the existing handle for identical geometry, or registers a new one.
+    MeshHandle get_or_create(std::vector<glm::vec3> vertices,
+                             std::vector<unsigned int> indices,
+                             std::vector<Color> colors = {});
+
+    // Runs the mesh_optimizer passes over the geometry, then registers it like
+    // get_or_create(). For imported meshes; `report`, if given, receives the cache
+    // statistics before and after.
+    MeshHandle get_or_create_optimized(std::vector<glm::vec3> vertices,
+                                       std::vector<unsigned int> indices,
+                                       std::vector<Color> colors = {},
+                                       mesh_optimizer::Report* report = nullptr);
+
+    // Wraps geometry that is known to be unique (e.g. chunk meshes) without hashing
+    // or registering it.
+    static MeshHandle create_unique(std::vector<glm::vec3> vertices,
+                                    std::vector<unsigned int> indices,
+                                    std::vector<Color> colors = {});
+
+    // Wraps unique voxel geometry in the packed vertex format.
+    static MeshHandle create_packed(std::vector<PackedVertex> vertices, std::vector<unsigned int> indices);
+
+    // Number of live unique meshes.
+    [[nodiscard]]
+    size_t size();
+
+    static std::uint64_t content_hash(const std::vector<glm::vec3>& vertices,
+                                      const std::vector<unsigned int>& indices,
+                                      const std::vector<Color>& colors);
+
+private:
+    void prune_expired();
+
+    std::mutex mutex_;
+    std::unordered_multimap<std::uint64_t, std::weak_ptr<const MeshData>> meshes_;
+    // Inserts since the last prune; expired entries are dropped once this reaches half the
+    // map size, which keeps pruning amortized O(1) per insert
+    size_t inserts_since_prune_{0};
+};
+
+#endif //MESH_REGISTRY_H
@@ -1,48 +1,70 @@
 #include "MouseKeyboardMovementComponent.h"
 
+#include <iterator>
+
+namespace {
+// Movement keys and the object-space direction each one moves in
+struct MovementKey {
+    int key;
+    glm::vec3 direction;
+};
+
+const MovementKey kMovementKeys[] = {
+    {GLFW_KEY_W, {0.0f, 0.0f, -1.0f}},
+    {GLFW_KEY_S, {0.0f, 0.0f, 1.0f}},
+    {GLFW_KEY_A, {-1.0f, 0.0f, 0.0f}},
+    {GLFW_KEY_D, {1.0f, 0.0f, 0.0f}},
+    {GLFW_KEY_Z, {0.0f, -1.0f, 0.0f}},
+    {GLFW_KEY_SPACE, {0.0f, 1.0f, 0.0f}},
+};
+}
+
 void MouseKeyboardMovementComponent::on_key_event(GLFWwindow* window, const int key, const int scancode, const int action, const int mods) {
-    if (action != GLFW_PRESS && action != GLFW_REPEAT) {
+    if (key == GLFW_KEY_R && action == GLFW_PRESS) {
+        reset_ = true;
+        return;
+    }
+
+    for (size_t i = 0; i < std::size(kMovementKeys); i++) {
+        if (kMovementKeys[i].key != key) {
+            continue;
+        }
+        if (action == GLFW_PRESS) {
+            held_keys_ |= static_cast<std::uint8_t>(1u << i);
+        } else if (action == GLFW_RELEASE) {
+            held_keys_ &= static_cast<std::uint8_t>(~(1u << i));
+        }
         return;
     }
+}
 
+void MouseKeyboardMovementComponent::update(const float deltaTime) {
     Transform& transform = game_object->get_transform();
 
-    if (key == GLFW_KEY_R && action == GLFW_PRESS) {
-        transform.position = glm::vec3(0.0f, 0.0f, 0.0f);
-        transform.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-        transform.scale = glm::vec3(1.0f, 1.0f, 1.0f);
+    if (reset_) {
+        reset_ = false;
+        pending_rotation_ = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        transform.set_position(glm::vec3(0.0f, 0.0f, 0.0f));
+        transform.set_rotation(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        transform.set_scale(glm::vec3(1.0f, 1.0f, 1.0f));
         return;
     }
 
-    glm::vec3 direction;
-    switch (key) {
-        case GLFW_KEY_W:
-            direction = glm::vec3(0.0f, 0.0f, -1.0f);
-        break;
-        case GLFW_KEY_S:
-            direction = glm::vec3(0.0f, 0.0f, 1.0f);
-        break;
-        case GLFW_KEY_A:
-            direction = glm::vec3(-1.0f, 0.0f, 0.0f);
-        break;
-        case GLFW_KEY_D:
-            direction = glm::vec3(1.0f, 0.0f, 0.0f);
-        break;
-        case GLFW_KEY_Z:
-            direction = glm::vec3(0.0f, -1.0f, 0.0f);
-        break;
-        case GLFW_KEY_SPACE:
-            direction = glm::vec3(0.0f, 1.0f, 0.0f);
-        break;
-        default:
-            return;
+    transform.set_rotation(glm::normalize(transform.rotation() * pending_rotation_));
+    pending_rotation_ = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+    glm::vec3 direction(0.0f);
+    for (size_t i = 0; i < std::size(kMovementKeys); i++) {
+        if (held_keys_ & (1u << i)) {
+            direction += kMovementKeys[i].direction;
+        }
     }
 
     // Rotate the direction vector by the object's rotation
-    const glm::vec3 rotated_direction = transform.rotation * direction;
+    const glm::vec3 rotated_direction = transform.rotation() * direction;
 
     // Update position
-    transform.position += rotated_direction;
+    transform.set_position(transform.position() + rotated_direction * (speed * deltaTime));
 }
 
 void MouseKeyboardMovementComponent::on_mouse_move(GLFWwindow *window, const double xpos, const double ypos) {
@@ -62,6 +84,5 @@ void MouseKeyboardMovementComponent::on_mouse_move(GLFWwindow *window, const dou
     const glm::quat yaw_lr_rotation = angleAxis(yaw_lr_radians, y_axis);
     const glm::quat pitch_ud_rotation = angleAxis(pitch_ud_radians, x_axis);
 
-    Transform& transform = game_object->get_transform();
-    transform.rotation = glm::normalize(transform.rotation * pitch_ud_rotation * yaw_lr_rotation);
+    pending_rotation_ = pending_rotation_ * pitch_ud_rotation * yaw_lr_rotation;
 }
@@ -1,8 +1,11 @@
 #ifndef MOUSE_KEYBOARD_MOVEMENT_COMPONENT_H
 #define MOUSE_KEYBOARD_MOVEMENT_COMPONENT_H
 
+#include <cstdint>
+
 #include "GameObject.h"
 #include "GLFW/glfw3.h"
+#include "glm/detail/type_quat.hpp"
 
 class KeyEventHandler {
 protected:
@@ -20,13 +23,24 @@ public:
     virtual void on_mouse_move(GLFWwindow* window, double xpos, double ypos) = 0;
 };
 
+// The event handlers only record input; update() applies it to the owner's
+// Transform. Events arrive on the main thread between update phases, so the two
+// never run at the same time.
 class MouseKeyboardMovementComponent final : public Component, public KeyEventHandler, public MouseEventHandler  {
 public:
     void on_key_event(GLFWwindow *window, int key, int scancode, int action, int mods) override;
     void on_mouse_move(GLFWwindow* window, double xpos, double ypos) override;
+    void update(float deltaTime) override;
 private:
-    float speed = 1.0f;
+    // Units per second while a movement key is held
+    float speed = 30.0f;
     float mouse_sensitivity = 0.1f;
+
+    // Bit per movement key held down, see on_key_event()
+    std::uint8_t held_keys_{0};
+    bool reset_{false};
+    // Mouse rotation accumulated since the last update
+    glm::quat pending_rotation_{1.0f, 0.0f, 0.0f, 0.0f};
 };
 
 #endif //MOUSE_KEYBOARD_MOVEMENT_COMPONENT_H
@@ -0,0 +1,62 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Unbounded lock-free multi-producer, single-consumer queue (Vyukov). push() is
+// wait-free and may be called from any thread; try_pop() must only be called from
+// one consumer thread. A push that is still in progress may be invisible to
+// try_pop() for a moment, which is fine for completion queues that are drained
+// every frame.
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() {
+        auto* stub = new Node;
+        head_.store(stub, std::memory_order_relaxed);
+        tail_ = stub;
+    }
+
+    ~MpscQueue() {
+        while (try_pop()) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        auto* node = new Node;
+        node->value.emplace(std::move(value));
+        Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    std::optional<T> try_pop() {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return std::nullopt;
+        }
+        std::optional<T> value = std::move(next->value);
+        next->value.reset();
+        // `next` becomes the new stub node
+        tail_ = next;
+        delete tail;
+        return value;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    alignas(64) std::atomic<Node*> head_;
+    alignas(64) Node* tail_;
+};
+
+#endif //MPSC_QUEUE_H
@@ -0,0 +1,141 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Seeded gradient noise (Perlin's improved noise), kLanes samples at a time.
+//
+// Gradients are picked by hashing the lattice point with the seed instead of
+// indexing a permutation table, so a sample is pure integer and float arithmetic:
+// no table to build per seed, no gathers, and the same value for the same seed on
+// every platform. Each function is a fixed-trip-count loop over independent
+// lanes, which the compiler vectorizes (SSE/AVX or NEON) without intrinsics.
+//
+// Results are roughly in [-1, 1] and 0 at every lattice point; one unit of input
+// is one lattice cell, so callers scale coordinates by the feature frequency.
+namespace noise {
+constexpr size_t kLanes = 8;
+
+namespace detail {
+constexpr std::uint32_t kPrimeX = 0x8da6b343u;
+constexpr std::uint32_t kPrimeY = 0xd8163841u;
+constexpr std::uint32_t kPrimeZ = 0xcb1ab31fu;
+
+// Finalizer spreading every input bit over the low bits the gradients use.
+constexpr std::uint32_t mix(std::uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+// std::floor without the library call, so the lane loops stay vectorizable.
+constexpr std::int32_t floor_to_int(const float value) {
+    const auto truncated = static_cast<std::int32_t>(value);
+    return truncated - (value < static_cast<float>(truncated) ? 1 : 0);
+}
+
+// Quintic smoothstep: continuous second derivative across cell borders.
+constexpr float fade(const float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+constexpr float lerp(const float a, const float b, const float t) {
+    return a + t * (b - a);
+}
+
+// Dot product with one of the four diagonal gradients.
+constexpr float gradient(const std::uint32_t h, const float x, const float z) {
+    return ((h & 1u) != 0 ? -x : x) + ((h & 2u) != 0 ? -z : z);
+}
+
+// Dot product with one of the twelve cube-edge gradients (Perlin 2002).
+constexpr float gradient(const std::uint32_t h, const float x, const float y, const float z) {
+    const std::uint32_t i = h & 15u;
+    const float u = i < 8u ? x : y;
+    const float v = i < 4u ? y : i == 12u || i == 14u ? x : z;
+    return ((i & 1u) != 0 ? -u : u) + ((i & 2u) != 0 ? -v : v);
+}
+}
+
+// Hash of a lattice point. The lane loops below multiply each coordinate once
+// and step to the next lattice point by adding the prime, which is the same value.
+constexpr std::uint32_t hash(const std::uint32_t seed, const std::int32_t x, const std::int32_t y,
+                             const std::int32_t z) {
+    return detail::mix(seed ^ static_cast<std::uint32_t>(x) * detail::kPrimeX
+                       ^ static_cast<std::uint32_t>(y) * detail::kPrimeY ^ static_cast<std::uint32_t>(z) * detail::kPrimeZ);
+}
+
+// out[i] = noise at (x[i], z[i]).
+inline void gradient2(const std::uint32_t seed, const float (&x)[kLanes], const float (&z)[kLanes],
+                      float (&out)[kLanes]) {
+    // Written to a local first: the compiler cannot rule out `out` aliasing the
+    // inputs, and at -O2 does not version loops to check
+    float result[kLanes];
+    for (size_t lane = 0; lane < kLanes; lane++) {
+        const std::int32_t ix = detail::floor_to_int(x[lane]);
+        const std::int32_t iz = detail::floor_to_int(z[lane]);
+        const float fx = x[lane] - static_cast<float>(ix);
+        const float fz = z[lane] - static_cast<float>(iz);
+
+        const std::uint32_t x0 = static_cast<std::uint32_t>(ix) * detail::kPrimeX;
+        const std::uint32_t x1 = x0 + detail::kPrimeX;
+        const std::uint32_t z0 = static_cast<std::uint32_t>(iz) * detail::kPrimeZ;
+        const std::uint32_t z1 = z0 + detail::kPrimeZ;
+
+        const float n00 = detail::gradient(detail::mix(seed ^ x0 ^ z0), fx, fz);
+        const float n10 = detail::gradient(detail::mix(seed ^ x1 ^ z0), fx - 1.0f, fz);
+        const float n01 = detail::gradient(detail::mix(seed ^ x0 ^ z1), fx, fz - 1.0f);
+        const float n11 = detail::gradient(detail::mix(seed ^ x1 ^ z1), fx - 1.0f, fz - 1.0f);
+
+        const float u = detail::fade(fx);
+        result[lane] = detail::lerp(detail::lerp(n00, n10, u), detail::lerp(n01, n11, u), detail::fade(fz));
+    }
+    std::copy_n(result, kLanes, out);
+}
+
+// out[i] = noise at (x[i], y[i], z[i]).
+inline void gradient3(const std::uint32_t seed, const float (&x)[kLanes], const float (&y)[kLanes],
+                      const float (&z)[kLanes], float (&out)[kLanes]) {
+    float result[kLanes];
+    for (size_t lane = 0; lane < kLanes; lane++) {
+        const std::int32_t ix = detail::floor_to_int(x[lane]);
+        const std::int32_t iy = detail::floor_to_int(y[lane]);
+        const std::int32_t iz = detail::floor_to_int(z[lane]);
+        const float fx = x[lane] - static_cast<float>(ix);
+        const float fy = y[lane] - static_cast<float>(iy);
+        const float fz = z[lane] - static_cast<float>(iz);
+
+        const std::uint32_t x0 = static_cast<std::uint32_t>(ix) * detail::kPrimeX;
+        const std::uint32_t x1 = x0 + detail::kPrimeX;
+        const std::uint32_t y0 = static_cast<std::uint32_t>(iy) * detail::kPrimeY;
+        const std::uint32_t y1 = y0 + detail::kPrimeY;
+        const std::uint32_t z0 = static_cast<std::uint32_t>(iz) * detail::kPrimeZ;
+        const std::uint32_t z1 = z0 + detail::kPrimeZ;
+
+        const float n000 = detail::gradient(detail::mix(seed ^ x0 ^ y0 ^ z0), fx, fy, fz);
+        const float n100 = detail::gradient(detail::mix(seed ^ x1 ^ y0 ^ z0), fx - 1.0f, fy, fz);
+        const float n010 = detail::gradient(detail::mix(seed ^ x0 ^ y1 ^ z0), fx, fy - 1.0f, fz);
+        const float n110 = detail::gradient(detail::mix(seed ^ x1 ^ y1 ^ z0), fx - 1.0f, fy - 1.0f, fz);
+        const float n001 = detail::gradient(detail::mix(seed ^ x0 ^ y0 ^ z1), fx, fy, fz - 1.0f);
+        const float n101 = detail::gradient(detail::mix(seed ^ x1 ^ y0 ^ z1), fx - 1.0f, fy, fz - 1.0f);
+        const float n011 = detail::gradient(detail::mix(seed ^ x0 ^ y1 ^ z1), fx, fy - 1.0f, fz - 1.0f);
+        const float n111 = detail::gradient(detail::mix(seed ^ x1 ^ y1 ^ z1), fx - 1.0f, fy - 1.0f, fz - 1.0f);
+
+        const float u = detail::fade(fx);
+        const float v = detail::fade(fy);
+        const float n00 = detail::lerp(n000, n100, u);
+        const float n10 = detail::lerp(n010, n110, u);
+        const float n01 = detail::lerp(n001, n101, u);
+        const float n11 = detail::lerp(n011, n111, u);
+        result[lane] = detail::lerp(detail::lerp(n00, n10, v), detail::lerp(n01, n11, v), detail::fade(fz));
+    }
+    std::copy_n(result, kLanes, out);
+}
+}
+
+#endif //NOISE_H
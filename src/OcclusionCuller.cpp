@@ -0,0 +1,230 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Corner i of a box has bit 0 set for max x, bit 1 for max y and bit 2 for max z.
+// Faces are wound counter-clockwise seen from outside, like OpenGL front faces.
+constexpr std::array<std::array<int, 4>, 6> kBoxFaces = {{
+    {0, 4, 6, 2}, {1, 3, 7, 5},
+    {0, 1, 5, 4}, {2, 6, 7, 3},
+    {0, 2, 3, 1}, {4, 5, 7, 6},
+}};
+
+// Occluders covering fewer pixels than this are not worth rasterizing.
+constexpr float kMinOccluderArea = 4.0f;
+
+// Keeps a box whose nearest point coincides with an occluder surface visible.
+constexpr float kDepthBias = 1e-6f;
+}
+
+OcclusionCuller::OcclusionCuller(const int width, const int height)
+    : tiles_x_((std::max(width, 1) + kTileWidth - 1) / kTileWidth),
+      tiles_y_((std::max(height, 1) + kTileHeight - 1) / kTileHeight) {
+    width_ = tiles_x_ * kTileWidth;
+    height_ = tiles_y_ * kTileHeight;
+    bins_.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+    depth_.assign(static_cast<size_t>(width_) * height_, 1.0f);
+    hierarchy_.assign(depth_.size() / (kBlockSize * kBlockSize), 1.0f);
+}
+
+void OcclusionCuller::begin_frame(const glm::mat4& view_projection) {
+    view_projection_ = view_projection;
+    triangles_.clear();
+    for (auto& bin: bins_) {
+        bin.clear();
+    }
+}
+
+bool OcclusionCuller::project(const Aabb& box, std::array<glm::vec3, 8>& corners) const {
+    for (int i = 0; i < 8; i++) {
+        const glm::vec4 corner((i & 1) ? box.max.x : box.min.x,
+                               (i & 2) ? box.max.y : box.min.y,
+                               (i & 4) ? box.max.z : box.min.z, 1.0f);
+        const glm::vec4 clip = view_projection_ * corner;
+        if (clip.w <= 1e-4f || clip.z < -clip.w) {
+            return false;
+        }
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        corners[i] = {
+            (ndc.x * 0.5f + 0.5f) * static_cast<float>(width_),
+            (ndc.y * 0.5f + 0.5f) * static_cast<float>(height_),
+            ndc.z * 0.5f + 0.5f,
+        };
+    }
+    return true;
+}
+
+void OcclusionCuller::add_occluder(const Aabb& box) {
+    std::array<glm::vec3, 8> corners;
+    if (!project(box, corners)) {
+        return;
+    }
+
+    glm::vec2 low(corners[0]), high(corners[0]);
+    for (const glm::vec3& corner: corners) {
+        low = glm::min(low, glm::vec2(corner));
+        high = glm::max(high, glm::vec2(corner));
+    }
+    const glm::vec2 size = glm::min(high, glm::vec2(static_cast<float>(width_), static_cast<float>(height_)))
+        - glm::max(low, glm::vec2(0.0f));
+    if (size.x <= 0.0f || size.y <= 0.0f || size.x * size.y < kMinOccluderArea) {
+        return;
+    }
+
+    for (const auto& face: kBoxFaces) {
+        add_triangle(corners[face[0]], corners[face[1]], corners[face[2]]);
+        add_triangle(corners[face[0]], corners[face[2]], corners[face[3]]);
+    }
+}
+
+void OcclusionCuller::add_triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area <= 0.0f) {
+        // Back facing or degenerate; the front faces cover the same pixels nearer
+        return;
+    }
+
+    Triangle triangle;
+    triangle.v0 = glm::vec2(a);
+    triangle.v1 = glm::vec2(b);
+    triangle.v2 = glm::vec2(c);
+    // Depth is affine in screen space after the perspective divide
+    triangle.dzdx = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) / area;
+    triangle.dzdy = ((c.z - a.z) * (b.x - a.x) - (b.z - a.z) * (c.x - a.x)) / area;
+    triangle.z0 = a.z - triangle.dzdx * a.x - triangle.dzdy * a.y;
+
+    triangle.min_x = std::max(static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))), 0);
+    triangle.min_y = std::max(static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))), 0);
+    triangle.max_x = std::min(static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))), width_ - 1);
+    triangle.max_y = std::min(static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))), height_ - 1);
+    if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y) {
+        return;
+    }
+
+    const auto index = static_cast<std::uint32_t>(triangles_.size());
+    triangles_.push_back(triangle);
+    for (int tile_y = triangle.min_y / kTileHeight; tile_y <= triangle.max_y / kTileHeight; tile_y++) {
+        for (int tile_x = triangle.min_x / kTileWidth; tile_x <= triangle.max_x / kTileWidth; tile_x++) {
+            bins_[static_cast<size_t>(tile_y) * tiles_x_ + tile_x].push_back(index);
+        }
+    }
+}
+
+void OcclusionCuller::rasterize(JobSystem* jobs) {
+    const size_t tiles = bins_.size();
+    if (jobs != nullptr) {
+        jobs->parallel_for(tiles, [this](const size_t tile) { rasterize_tile(tile); });
+    } else {
+        for (size_t tile = 0; tile < tiles; tile++) {
+            rasterize_tile(tile);
+        }
+    }
+}
+
+void OcclusionCuller::rasterize_tile(const size_t tile) {
+    const int tile_x0 = static_cast<int>(tile % tiles_x_) * kTileWidth;
+    const int tile_y0 = static_cast<int>(tile / tiles_x_) * kTileHeight;
+    const int tile_x1 = tile_x0 + kTileWidth;
+    const int tile_y1 = tile_y0 + kTileHeight;
+
+    for (int y = tile_y0; y < tile_y1; y++) {
+        std::fill_n(depth_.begin() + static_cast<std::ptrdiff_t>(y) * width_ + tile_x0, kTileWidth, 1.0f);
+    }
+    for (const std::uint32_t index: bins_[tile]) {
+        rasterize_triangle(triangles_[index], tile_x0, tile_y0, tile_x1, tile_y1);
+    }
+    build_hierarchy(tile_x0, tile_y0, tile_x1, tile_y1);
+}
+
+void OcclusionCuller::rasterize_triangle(const Triangle& triangle, const int tile_x0, const int tile_y0,
+                                         const int tile_x1, const int tile_y1) {
+    constexpr int kLanes = 8;
+    const int min_x = std::max(triangle.min_x, tile_x0) / kLanes * kLanes;
+    const int max_x = std::min(triangle.max_x, tile_x1 - 1);
+    const int min_y = std::max(triangle.min_y, tile_y0);
+    const int max_y = std::min(triangle.max_y, tile_y1 - 1);
+
+    // Edge functions e(x, y) = a * x + b * y + c, positive inside for CCW triangles.
+    // Everything the pixel loop reads is a local so it cannot alias the depth buffer.
+    const glm::vec2 v0 = triangle.v0, v1 = triangle.v1, v2 = triangle.v2;
+    const float a0 = v0.y - v1.y, b0 = v1.x - v0.x, c0 = v0.x * v1.y - v0.y * v1.x;
+    const float a1 = v1.y - v2.y, b1 = v2.x - v1.x, c1 = v1.x * v2.y - v1.y * v2.x;
+    const float a2 = v2.y - v0.y, b2 = v0.x - v2.x, c2 = v2.x * v0.y - v2.y * v0.x;
+    const float z0 = triangle.z0, dzdx = triangle.dzdx, dzdy = triangle.dzdy;
+
+    for (int y = min_y; y <= max_y; y++) {
+        const float center_y = static_cast<float>(y) + 0.5f;
+        const float row0 = b0 * center_y + c0;
+        const float row1 = b1 * center_y + c1;
+        const float row2 = b2 * center_y + c2;
+        const float row_z = z0 + dzdy * center_y;
+        float* row = depth_.data() + static_cast<size_t>(y) * width_;
+        for (int x = min_x; x <= max_x; x += kLanes) {
+            const float base_x = static_cast<float>(x) + 0.5f;
+            float* __restrict pixels = row + x;
+            // Fixed-width, branch-free lanes; x stays within the tile, which is a multiple of kLanes wide
+            for (int lane = 0; lane < kLanes; lane++) {
+                const float center_x = base_x + static_cast<float>(lane);
+                const float e0 = a0 * center_x + row0;
+                const float e1 = a1 * center_x + row1;
+                const float e2 = a2 * center_x + row2;
+                const float z = row_z + dzdx * center_x;
+                // Inside when the smallest edge value is non-negative; no short-circuit branches
+                const float inside = std::min(e0, std::min(e1, e2));
+                const float nearer = std::min(pixels[lane], z);
+                pixels[lane] = inside >= 0.0f ? nearer : pixels[lane];
+            }
+        }
+    }
+}
+
+void OcclusionCuller::build_hierarchy(const int tile_x0, const int tile_y0, const int tile_x1, const int tile_y1) {
+    const int blocks_x = width_ / kBlockSize;
+    for (int block_y = tile_y0 / kBlockSize; block_y < tile_y1 / kBlockSize; block_y++) {
+        for (int block_x = tile_x0 / kBlockSize; block_x < tile_x1 / kBlockSize; block_x++) {
+            float farthest = 0.0f;
+            for (int y = block_y * kBlockSize; y < (block_y + 1) * kBlockSize; y++) {
+                const float* row = depth_.data() + static_cast<size_t>(y) * width_ + block_x * kBlockSize;
+                for (int x = 0; x < kBlockSize; x++) {
+                    farthest = std::max(farthest, row[x]);
+                }
+            }
+            hierarchy_[static_cast<size_t>(block_y) * blocks_x + block_x] = farthest;
+        }
+    }
+}
+
+bool OcclusionCuller::is_visible(const Aabb& box) const {
+    std::array<glm::vec3, 8> corners;
+    if (!project(box, corners)) {
+        // Crosses the near plane: too close to bother
+        return true;
+    }
+
+    glm::vec3 low = corners[0], high = corners[0];
+    for (const glm::vec3& corner: corners) {
+        low = glm::min(low, corner);
+        high = glm::max(high, corner);
+    }
+    if (high.x < 0.0f || high.y < 0.0f || low.x >= static_cast<float>(width_) || low.y >= static_cast<float>(height_)) {
+        return false;
+    }
+
+    const int blocks_x = width_ / kBlockSize;
+    const int block_x0 = std::max(static_cast<int>(low.x), 0) / kBlockSize;
+    const int block_y0 = std::max(static_cast<int>(low.y), 0) / kBlockSize;
+    const int block_x1 = std::min(static_cast<int>(high.x), width_ - 1) / kBlockSize;
+    const int block_y1 = std::min(static_cast<int>(high.y), height_ - 1) / kBlockSize;
+    const float nearest = low.z - kDepthBias;
+    for (int block_y = block_y0; block_y <= block_y1; block_y++) {
+        const float* row = hierarchy_.data() + static_cast<size_t>(block_y) * blocks_x;
+        for (int block_x = block_x0; block_x <= block_x1; block_x++) {
+            if (row[block_x] >= nearest) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,92 @@
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "Bounds.h"
+#include "JobSystem.h"
+
+// Software occlusion culling: large occluder boxes are rasterized into a small CPU
+// depth buffer, which is reduced to a hierarchical (max-depth per 8x8 block) buffer
+// that object bounds are tested against. Needs no GPU, so it also runs headless.
+//
+// The screen is split into tiles. Occluder triangles are binned per tile and each
+// tile is rasterized as one job; rows are processed 8 pixels at a time with
+// fixed-width, branch-free loops that the compiler vectorizes.
+//
+// Occluders must lie inside solid geometry. Depth is sampled at pixel centers, so
+// at this resolution an occluder can cover a pixel it only partly overlaps; the
+// test itself is conservative.
+//
+// Per frame: begin_frame(), add_occluder() for each occluder, rasterize(), then
+// any number of is_visible() calls.
+class OcclusionCuller {
+public:
+    static constexpr int kTileWidth = 64;
+    static constexpr int kTileHeight = 32;
+    static constexpr int kBlockSize = 8;
+
+    // Dimensions are rounded up to whole tiles.
+    explicit OcclusionCuller(int width = 256, int height = 128);
+
+    void begin_frame(const glm::mat4& view_projection);
+
+    // Queues the front faces of `box`. Occluders crossing the near plane or smaller
+    // than a few pixels on screen are skipped.
+    void add_occluder(const Aabb& box);
+
+    // Builds the depth and hierarchical depth buffers, in parallel if `jobs` is given.
+    void rasterize(JobSystem* jobs = nullptr);
+
+    // False only if `box` is entirely hidden behind rasterized occluders or off screen.
+    [[nodiscard]]
+    bool is_visible(const Aabb& box) const;
+
+    [[nodiscard]]
+    int width() const { return width_; }
+
+    [[nodiscard]]
+    int height() const { return height_; }
+
+    // Window-space depth in [0, 1], row 0 at the bottom of the screen.
+    [[nodiscard]]
+    std::span<const float> depth() const { return depth_; }
+
+    [[nodiscard]]
+    size_t occluder_triangles() const { return triangles_.size(); }
+
+private:
+    struct Triangle {
+        // Screen-space vertices (pixels) and depth plane z = z0 + dzdx * x + dzdy * y
+        glm::vec2 v0, v1, v2;
+        float z0, dzdx, dzdy;
+        int min_x, min_y, max_x, max_y;
+    };
+
+    // Projected box corners; false if any corner is at or behind the near plane.
+    bool project(const Aabb& box, std::array<glm::vec3, 8>& corners) const;
+    void add_triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+    void rasterize_tile(size_t tile);
+    void rasterize_triangle(const Triangle& triangle, int tile_x0, int tile_y0, int tile_x1, int tile_y1);
+    void build_hierarchy(int tile_x0, int tile_y0, int tile_x1, int tile_y1);
+
+    int width_;
+    int height_;
+    int tiles_x_;
+    int tiles_y_;
+    glm::mat4 view_projection_{1.0f};
+
+    std::vector<Triangle> triangles_;
+    // Triangle indices overlapping each tile
+    std::vector<std::vector<std::uint32_t>> bins_;
+
+    std::vector<float> depth_;
+    // Farthest depth per kBlockSize^2 block
+    std::vector<float> hierarchy_;
+};
+
+#endif //OCCLUSION_CULLER_H
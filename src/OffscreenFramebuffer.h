@@ -0,0 +1,37 @@
+#ifndef OFFSCREEN_FRAMEBUFFER_H
+#define OFFSCREEN_FRAMEBUFFER_H
+
+#include <GLFW/glfw3.h>
+
+// A framebuffer object with color and depth renderbuffers of a fixed size, for
+// rendering without a visible window: the contents of a hidden window's default
+// framebuffer are undefined, and its size is up to the window system.
+//
+// Requires a current OpenGL 3.3 core context for its whole lifetime.
+class OffscreenFramebuffer {
+public:
+    // Throws std::runtime_error if the driver cannot render to it.
+    OffscreenFramebuffer(int width, int height);
+    ~OffscreenFramebuffer();
+
+    OffscreenFramebuffer(const OffscreenFramebuffer&) = delete;
+    OffscreenFramebuffer& operator=(const OffscreenFramebuffer&) = delete;
+
+    // Directs rendering here until another framebuffer is bound.
+    void bind() const;
+
+    [[nodiscard]]
+    int width() const { return width_; }
+
+    [[nodiscard]]
+    int height() const { return height_; }
+
+private:
+    int width_;
+    int height_;
+    GLuint framebuffer_{0};
+    GLuint color_{0};
+    GLuint depth_{0};
+};
+
+#endif //OFFSCREEN_FRAMEBUFFER_H
@@ -5,27 +5,29 @@
 #ifndef OPENGLDEBUG_H
 #define OPENGLDEBUG_H
 
+#include <array>
 #include <iostream>
 #include <GLFW/glfw3.h>
 
+#include "Renderer.h"
+#include "Transform.h"
+
 namespace debug {
-inline void drawDebugAxes() {
-    glBegin(GL_LINES);
-    // X axis - Red
-    glColor3f(1.0f, 0.0f, 0.0f);
-    glVertex3f(0.0f, 0.0f, 0.0f);
-    glVertex3f(1.0f, 0.0f, 0.0f);
+inline void drawDebugAxes(Renderer& renderer) {
+    const std::array<LineVertex, 6> axes = {{
+        // X axis - Red
+        {{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},
+        {{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},
 
-    // Y axis - Green
-    glColor3f(0.0f, 1.0f, 0.0f);
-    glVertex3f(0.0f, 0.0f, 0.0f);
-    glVertex3f(0.0f, 1.0f, 0.0f);
+        // Y axis - Green
+        {{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}},
+        {{0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}},
 
-    // Z axis - Blue
-    glColor3f(0.0f, 0.0f, 1.0f);
-    glVertex3f(0.0f, 0.0f, 0.0f);
-    glVertex3f(0.0f, 0.0f, 1.0f);
-    glEnd();
+        // Z axis - Blue
+        {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 1.0f}},
+        {{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f, 1.0f}},
+    }};
+    renderer.draw_lines(axes);
 }
 
 inline void debugViewport() {
@@ -37,16 +39,11 @@ inline void debugViewport() {
               << " height=" << viewport[3] << std::endl;
 }
 
-inline void debugMatrices() {
-    GLfloat modelview[16];
-    GLfloat projection[16];
-    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
-    glGetFloatv(GL_PROJECTION_MATRIX, projection);
-
-    std::cout << "Modelview Matrix:\n";
+inline void debugMatrices(const glm::mat4& view, const glm::mat4& projection) {
+    std::cout << "View Matrix:\n";
     for(int i = 0; i < 4; i++) {
         for(int j = 0; j < 4; j++) {
-            std::cout << modelview[i * 4 + j] << " ";
+            std::cout << view[i][j] << " ";
         }
         std::cout << "\n";
     }
@@ -54,34 +51,61 @@ inline void debugMatrices() {
     std::cout << "Projection Matrix:\n";
     for(int i = 0; i < 4; i++) {
         for(int j = 0; j < 4; j++) {
-            std::cout << projection[i * 4 + j] << " ";
+            std::cout << projection[i][j] << " ";
         }
         std::cout << "\n";
     }
 }
 
-inline void drawBoundingBox(const float size = 1.0f) {
-    glBegin(GL_LINE_LOOP);
-    glColor3f(1.0f, 1.0f, 1.0f);  // White
-    float s = size/2;
+inline void drawBoundingBox(Renderer& renderer, const float size = 1.0f) {
+    constexpr Color white = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float s = size/2;
     // Front face
-    glVertex3f(-s, -s, s);
-    glVertex3f(s, -s, s);
-    glVertex3f(s, s, s);
-    glVertex3f(-s, s, s);
-    glEnd();
+    const std::array<glm::vec3, 4> corners = {{
+        {-s, -s, s},
+        {s, -s, s},
+        {s, s, s},
+        {-s, s, s},
+    }};
+    std::array<LineVertex, 8> lines{};
+    for (size_t i = 0; i < corners.size(); i++) {
+        lines[i * 2] = {corners[i], white};
+        lines[i * 2 + 1] = {corners[(i + 1) % corners.size()], white};
+    }
+    renderer.draw_lines(lines);
     // Add other faces similarly
 }
 
+// Outlines the box [min, max] with its 12 edges.
+inline void drawBox(Renderer& renderer, const glm::vec3& min, const glm::vec3& max, const Color& color) {
+    std::array<LineVertex, 24> lines{};
+    size_t count = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        // Edges along `axis` start at the four corners with that coordinate at min
+        for (int corner = 0; corner < 4; corner++) {
+            const int u = (axis + 1) % 3;
+            const int v = (axis + 2) % 3;
+            glm::vec3 start = min;
+            start[u] = corner & 1 ? max[u] : min[u];
+            start[v] = corner & 2 ? max[v] : min[v];
+            glm::vec3 end = start;
+            end[axis] = max[axis];
+            lines[count++] = {start, color};
+            lines[count++] = {end, color};
+        }
+    }
+    renderer.draw_lines(lines);
+}
+
 inline void debugTransform(const Transform& transform) {
     std::cout << "Position: "
-              << transform.position.x << ", "
-              << transform.position.y << ", "
-              << transform.position.z << "\n";
+              << transform.position().x << ", "
+              << transform.position().y << ", "
+              << transform.position().z << "\n";
     std::cout << "Scale: "
-              << transform.scale.x << ", "
-              << transform.scale.y << ", "
-              << transform.scale.z << "\n";
+              << transform.scale().x << ", "
+              << transform.scale().y << ", "
+              << transform.scale().z << "\n";
 }
 
 inline void check_opengl_errors(const char* label) {
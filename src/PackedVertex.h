@@ -0,0 +1,63 @@
+#ifndef PACKED_VERTEX_H
+#define PACKED_VERTEX_H
+
+#include <cstdint>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Chunk.h"
+#include "Light.h"
+
+// 8-byte vertex for voxel meshes, decoded by the renderer's voxel shader.
+//
+//   word 0: x (6 bits) | y (6) | z (6) | face (3) | ao (2) | unused (9)
+//   word 1: block (16 bits) | light (8) | unused (8)
+//
+// Positions are chunk-local block corners, so 0..kChunkSize inclusive; the face
+// selects the shading, ao is 0 (fully occluded) to 3 (open) and the block indexes
+// the color palette. Light is the baked light::Level of the block in front of the
+// face.
+struct PackedVertex {
+    std::uint32_t position{0};
+    std::uint32_t material{0};
+
+    static constexpr int kPositionBits = 6;
+    static constexpr std::uint32_t kPositionMask = (1u << kPositionBits) - 1;
+    static constexpr std::uint32_t kMaxAo = 3;
+
+    static constexpr PackedVertex pack(const int x, const int y, const int z, const Face face,
+                                       const std::uint32_t ao, const BlockId block,
+                                       const light::Level light = light::kFullSky) {
+        return {
+            static_cast<std::uint32_t>(x) | static_cast<std::uint32_t>(y) << 6 | static_cast<std::uint32_t>(z) << 12
+                | static_cast<std::uint32_t>(face) << 18 | ao << 21,
+            static_cast<std::uint32_t>(block) | static_cast<std::uint32_t>(light) << 16,
+        };
+    }
+
+    [[nodiscard]]
+    constexpr glm::ivec3 local_position() const {
+        return {
+            static_cast<int>(position & kPositionMask),
+            static_cast<int>(position >> 6 & kPositionMask),
+            static_cast<int>(position >> 12 & kPositionMask),
+        };
+    }
+
+    [[nodiscard]]
+    constexpr Face face() const { return static_cast<Face>(position >> 18 & 7u); }
+
+    [[nodiscard]]
+    constexpr std::uint32_t ao() const { return position >> 21 & 3u; }
+
+    [[nodiscard]]
+    constexpr BlockId block() const { return static_cast<BlockId>(material & 0xFFFFu); }
+
+    [[nodiscard]]
+    constexpr light::Level light() const { return static_cast<light::Level>(material >> 16 & 0xFFu); }
+};
+
+static_assert(sizeof(PackedVertex) == 8);
+static_assert(kChunkSize <= static_cast<int>(PackedVertex::kPositionMask), "Chunk corners must fit the position fields");
+
+#endif //PACKED_VERTEX_H
@@ -0,0 +1,259 @@
+#ifndef PALETTED_CHUNK_H
+#define PALETTED_CHUNK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Chunk.h"
+
+// Palette-compressed chunk with the same get/set API as Chunk.
+//
+// Blocks are stored as indices into a per-chunk palette, packed at 1, 2, 4 or 8
+// bits per block depending on the palette size; the width doubles (and the data
+// is repacked) when the palette outgrows it. Chunks with more than 256 distinct
+// blocks store raw 16-bit ids instead. A chunk of a single block (e.g. all air)
+// stores no per-block data at all.
+//
+// Entries never straddle a 64-bit word, so reads are one load, shift and mask.
+template<int Size, typename BlockT = BlockId>
+class PalettedChunk {
+public:
+    static_assert(sizeof(BlockT) <= 2, "Direct mode stores block ids in 16 bits");
+
+    using Block = BlockT;
+    using LayoutType = YMajorLayout;
+
+    static constexpr int kSize = Size;
+    static constexpr int kPadding = 0;
+    static constexpr size_t kVolume = static_cast<size_t>(Size) * Size * Size;
+
+    explicit PalettedChunk(const BlockT fill_value = BlockT{}) { fill(fill_value); }
+
+    static constexpr size_t index(const int x, const int y, const int z) {
+        return YMajorLayout::index<Size>(x, y, z);
+    }
+
+    static constexpr bool contains(const int x, const int y, const int z) {
+        return x >= 0 && y >= 0 && z >= 0 && x < Size && y < Size && z < Size;
+    }
+
+    [[nodiscard]]
+    BlockT get(const int x, const int y, const int z) const {
+        if (bits_ == 0) {
+            return palette_[0];
+        }
+        const std::uint32_t value = read(index(x, y, z));
+        return direct_ ? static_cast<BlockT>(value) : palette_[value];
+    }
+
+    [[nodiscard]]
+    BlockT get(const glm::ivec3& p) const { return get(p.x, p.y, p.z); }
+
+    void set(const int x, const int y, const int z, const BlockT block) {
+        if (bits_ == 0 && palette_[0] == block) {
+            return;
+        }
+        const std::uint32_t value = direct_ ? static_cast<std::uint32_t>(block) : palette_index(block);
+        write(index(x, y, z), value);
+    }
+
+    void set(const glm::ivec3& p, const BlockT block) { set(p.x, p.y, p.z, block); }
+
+    // Resets to the single-value representation.
+    void fill(const BlockT block) {
+        palette_.assign(1, block);
+        data_.clear();
+        data_.shrink_to_fit();
+        bits_ = 0;
+        direct_ = false;
+    }
+
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        size_t i = 0;
+        for (int y = 0; y < Size; y++) {
+            for (int z = 0; z < Size; z++) {
+                for (int x = 0; x < Size; x++, i++) {
+                    if (bits_ == 0) {
+                        fn(x, y, z, palette_[0]);
+                    } else {
+                        const std::uint32_t value = read(i);
+                        fn(x, y, z, direct_ ? static_cast<BlockT>(value) : palette_[value]);
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]]
+    size_t count_solid() const {
+        size_t count = 0;
+        for_each([&](int, int, int, const BlockT block) { count += block != BlockT{} ? 1 : 0; });
+        return count;
+    }
+
+    // True when every block has the same value and no per-block data is stored.
+    [[nodiscard]]
+    bool is_uniform() const { return bits_ == 0; }
+
+    [[nodiscard]]
+    int bits_per_block() const { return bits_; }
+
+    [[nodiscard]]
+    const std::vector<BlockT>& palette() const { return palette_; }
+
+    // Heap plus inline bytes held by this chunk.
+    [[nodiscard]]
+    size_t memory_usage() const {
+        return sizeof(*this) + palette_.capacity() * sizeof(BlockT) + data_.capacity() * sizeof(std::uint64_t);
+    }
+
+    // Drops palette entries that are no longer referenced and repacks at the
+    // smallest width, collapsing to a single value when possible.
+    void compact() {
+        if (bits_ == 0) {
+            return;
+        }
+        std::vector<BlockT> blocks(kVolume);
+        for_each([&](const int x, const int y, const int z, const BlockT block) { blocks[index(x, y, z)] = block; });
+        assign(blocks);
+    }
+
+    template<typename Dense>
+    static PalettedChunk from_dense(const Dense& dense) {
+        static_assert(Dense::kSize == Size);
+        std::vector<BlockT> blocks(kVolume);
+        dense.for_each([&](const int x, const int y, const int z, const BlockT block) { blocks[index(x, y, z)] = block; });
+        PalettedChunk chunk;
+        chunk.assign(blocks);
+        return chunk;
+    }
+
+    template<typename Dense>
+    void to_dense(Dense& dense) const {
+        static_assert(Dense::kSize == Size);
+        for_each([&](const int x, const int y, const int z, const BlockT block) { dense.set(x, y, z, block); });
+    }
+
+private:
+    static constexpr int kMaxPaletteBits = 8;
+    static constexpr int kDirectBits = 16;
+    static constexpr size_t kBranchlessSearch = 16;
+    static constexpr std::uint32_t kNotFound = ~std::uint32_t{0};
+
+    [[nodiscard]]
+    std::uint32_t read(const size_t i) const {
+        const size_t bit = i * bits_;
+        return static_cast<std::uint32_t>(data_[bit >> 6] >> (bit & 63)) & mask_;
+    }
+
+    void write(const size_t i, const std::uint32_t value) {
+        const size_t bit = i * bits_;
+        std::uint64_t& word = data_[bit >> 6];
+        word = (word & ~(static_cast<std::uint64_t>(mask_) << (bit & 63)))
+             | (static_cast<std::uint64_t>(value) << (bit & 63));
+    }
+
+    // Palette index of `block`, adding it (and widening storage) if needed.
+    std::uint32_t palette_index(const BlockT block) {
+        const size_t size = palette_.size();
+        if (size <= kBranchlessSearch) {
+            // Random edits make an early-exit search mispredict on almost every call
+            std::uint32_t found = kNotFound;
+            for (size_t i = 0; i < size; i++) {
+                found = palette_[i] == block ? static_cast<std::uint32_t>(i) : found;
+            }
+            if (found != kNotFound) {
+                return found;
+            }
+        } else if (const auto it = std::ranges::find(palette_, block); it != palette_.end()) {
+            return static_cast<std::uint32_t>(it - palette_.begin());
+        }
+        palette_.push_back(block);
+        const size_t needed = palette_.size();
+        if (needed > (size_t{1} << bits_)) {
+            int bits = std::max<int>(bits_, 1);
+            while ((size_t{1} << bits) < needed) {
+                bits *= 2;
+            }
+            resize(bits);
+            if (direct_) {
+                return static_cast<std::uint32_t>(block);
+            }
+        }
+        return static_cast<std::uint32_t>(palette_.size() - 1);
+    }
+
+    // Repacks every block at `bits` per block, switching to direct ids past the
+    // palette limit.
+    void resize(const int bits) {
+        const bool direct = bits > kMaxPaletteBits;
+        const int new_bits = direct ? kDirectBits : bits;
+
+        std::vector<std::uint64_t> data((kVolume * new_bits + 63) / 64);
+        const std::uint32_t new_mask = (std::uint32_t{1} << new_bits) - 1;
+        for (size_t i = 0; i < kVolume; i++) {
+            std::uint32_t value = 0;
+            if (bits_ != 0) {
+                value = read(i);
+            }
+            if (direct) {
+                value = direct_ ? value : static_cast<std::uint32_t>(palette_[value]);
+            }
+            const size_t bit = i * new_bits;
+            data[bit >> 6] |= static_cast<std::uint64_t>(value & new_mask) << (bit & 63);
+        }
+
+        data_ = std::move(data);
+        bits_ = new_bits;
+        mask_ = new_mask;
+        direct_ = direct;
+    }
+
+    // Rebuilds palette and data from a Y-major array of block ids.
+    void assign(const std::vector<BlockT>& blocks) {
+        std::vector<BlockT> palette;
+        for (const BlockT block : blocks) {
+            if (std::ranges::find(palette, block) == palette.end()) {
+                palette.push_back(block);
+                if (palette.size() > (size_t{1} << kMaxPaletteBits)) {
+                    break;
+                }
+            }
+        }
+
+        fill(blocks[0]);
+        if (palette.size() == 1) {
+            return;
+        }
+        const bool direct = palette.size() > (size_t{1} << kMaxPaletteBits);
+        int bits = 1;
+        while (!direct && (size_t{1} << bits) < palette.size()) {
+            bits *= 2;
+        }
+        palette_ = direct ? std::vector<BlockT>{} : palette;
+        bits_ = direct ? kDirectBits : bits;
+        mask_ = (std::uint32_t{1} << bits_) - 1;
+        direct_ = direct;
+        data_.assign((kVolume * bits_ + 63) / 64, 0);
+        for (size_t i = 0; i < kVolume; i++) {
+            const auto value = direct
+                ? static_cast<std::uint32_t>(blocks[i])
+                : static_cast<std::uint32_t>(std::ranges::find(palette_, blocks[i]) - palette_.begin());
+            write(i, value);
+        }
+    }
+
+    std::vector<BlockT> palette_;
+    std::vector<std::uint64_t> data_;
+    std::uint32_t mask_{0};
+    std::uint8_t bits_{0};
+    bool direct_{false};
+};
+
+using CompactChunk = PalettedChunk<kChunkSize>;
+
+#endif //PALETTED_CHUNK_H
@@ -0,0 +1,283 @@
+#include "RegionFile.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <span>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The on-disk format is little-endian and written straight from memory
+static_assert(std::endian::native == std::endian::little);
+
+namespace {
+enum class Codec : std::uint8_t {
+    Raw = 0,
+    RunLength = 1,
+};
+
+// Each run is a (count, block) pair of 16-bit values.
+struct Run {
+    std::uint16_t count;
+    BlockId block;
+};
+
+// Payload header: codec byte padded to keep the data 4-byte aligned.
+constexpr size_t kPayloadHeader = 4;
+
+std::vector<std::byte> encode(const DenseChunk& chunk) {
+    const std::span<const BlockId> blocks = chunk.data();
+
+    std::vector<Run> runs;
+    for (size_t i = 0; i < blocks.size();) {
+        size_t end = i + 1;
+        while (end < blocks.size() && blocks[end] == blocks[i] && end - i < 0xFFFF) {
+            end++;
+        }
+        runs.push_back({static_cast<std::uint16_t>(end - i), blocks[i]});
+        i = end;
+    }
+
+    const bool run_length = runs.size() * sizeof(Run) < blocks.size_bytes();
+    const size_t data_size = run_length ? runs.size() * sizeof(Run) : blocks.size_bytes();
+    std::vector<std::byte> payload(kPayloadHeader + data_size);
+    payload[0] = static_cast<std::byte>(run_length ? Codec::RunLength : Codec::Raw);
+    std::memcpy(payload.data() + kPayloadHeader, run_length ? static_cast<const void*>(runs.data()) : blocks.data(),
+                data_size);
+    return payload;
+}
+
+bool decode(const std::span<const std::byte> payload, DenseChunk& chunk) {
+    if (payload.size() < kPayloadHeader) {
+        return false;
+    }
+    const std::span<const std::byte> data = payload.subspan(kPayloadHeader);
+    const std::span<BlockId> blocks = chunk.data();
+
+    switch (static_cast<Codec>(payload[0])) {
+        case Codec::Raw:
+            if (data.size() != blocks.size_bytes()) {
+                return false;
+            }
+            std::memcpy(blocks.data(), data.data(), data.size());
+            return true;
+        case Codec::RunLength: {
+            size_t position = 0;
+            for (size_t offset = 0; offset + sizeof(Run) <= data.size(); offset += sizeof(Run)) {
+                Run run;
+                std::memcpy(&run, data.data() + offset, sizeof(Run));
+                if (position + run.count > blocks.size()) {
+                    return false;
+                }
+                std::fill_n(blocks.begin() + static_cast<std::ptrdiff_t>(position), run.count, run.block);
+                position += run.count;
+            }
+            return position == blocks.size();
+        }
+    }
+    return false;
+}
+
+std::runtime_error io_error(const std::string& what, const std::filesystem::path& path) {
+    return std::runtime_error(what + " " + path.string() + ": " + std::strerror(errno));
+}
+
+// Floor division, so chunk -1 lands in region -1
+int floor_div(const int value, const int divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+}
+
+RegionFile::RegionFile(const std::filesystem::path& path) : path_(path), entries_(kChunkCount) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw io_error("Failed to open region", path);
+    }
+
+    struct stat info{};
+    if (::fstat(fd_, &info) != 0) {
+        ::close(fd_);
+        throw io_error("Failed to stat region", path);
+    }
+
+    try {
+        if (info.st_size == 0) {
+            // New region: magic, version and an all-absent table
+            std::vector<std::byte> header(kHeaderSectors * kSectorSize);
+            std::memcpy(header.data(), &kMagic, sizeof(kMagic));
+            std::memcpy(header.data() + 4, &kVersion, sizeof(kVersion));
+            write_at(header.data(), header.size(), 0);
+            info.st_size = static_cast<off_t>(header.size());
+        }
+
+        const auto size = static_cast<size_t>(info.st_size);
+        if (size < kHeaderSectors * kSectorSize) {
+            throw std::runtime_error("Truncated region file " + path.string());
+        }
+        map_ = map(size);
+        map_size_ = size;
+
+        std::uint32_t magic, version;
+        std::memcpy(&magic, map_, sizeof(magic));
+        std::memcpy(&version, map_ + 4, sizeof(version));
+        if (magic != kMagic || version != kVersion) {
+            throw std::runtime_error("Not a version " + std::to_string(kVersion) + " region file: " + path.string());
+        }
+        std::memcpy(entries_.data(), map_ + 8, kChunkCount * sizeof(Entry));
+
+        used_sectors_.assign(sectors_for(size), false);
+        std::fill_n(used_sectors_.begin(), kHeaderSectors, true);
+        for (const Entry& entry: entries_) {
+            if (entry.size == 0) {
+                continue;
+            }
+            if (entry.sector < kHeaderSectors || entry.sector + sectors_for(entry.size) > used_sectors_.size()) {
+                throw std::runtime_error("Corrupt chunk table in region file " + path.string());
+            }
+            std::fill_n(used_sectors_.begin() + entry.sector, sectors_for(entry.size), true);
+        }
+    } catch (...) {
+        unmap();
+        ::close(fd_);
+        throw;
+    }
+}
+
+RegionFile::~RegionFile() {
+    unmap();
+    ::close(fd_);
+}
+
+ChunkPos RegionFile::region_of(const ChunkPos& chunk) {
+    return {floor_div(chunk.x, kSize), floor_div(chunk.y, kSize), floor_div(chunk.z, kSize)};
+}
+
+ChunkPos RegionFile::local_of(const ChunkPos& chunk) {
+    return chunk - region_of(chunk) * kSize;
+}
+
+size_t RegionFile::index(const ChunkPos& local) {
+    return (static_cast<size_t>(local.y) * kSize + static_cast<size_t>(local.z)) * kSize + static_cast<size_t>(local.x);
+}
+
+bool RegionFile::contains(const ChunkPos& local) const {
+    std::shared_lock lock(mutex_);
+    return entries_[index(local)].size != 0;
+}
+
+bool RegionFile::read(const ChunkPos& local, DenseChunk& chunk) const {
+    std::shared_lock lock(mutex_);
+    const Entry& entry = entries_[index(local)];
+    if (entry.size == 0) {
+        return false;
+    }
+    const std::span payload(map_ + static_cast<size_t>(entry.sector) * kSectorSize, entry.size);
+    if (!decode(payload, chunk)) {
+        throw std::runtime_error("Corrupt chunk payload in region file " + path_.string());
+    }
+    return true;
+}
+
+void RegionFile::write(const ChunkPos& local, const DenseChunk& chunk) {
+    const std::vector<std::byte> payload = encode(chunk);
+    const size_t sectors = sectors_for(payload.size());
+
+    std::unique_lock lock(mutex_);
+    const size_t slot = index(local);
+    const Entry old = entries_[slot];
+
+    // Never over the old payload: it stays allocated until the table points away
+    // from it, so a write cut short leaves the old entry and payload intact.
+    // allocate() changes nothing when it throws, so only the writes need undoing
+    Entry entry;
+    entry.sector = static_cast<std::uint32_t>(allocate(sectors));
+    entry.size = static_cast<std::uint32_t>(payload.size());
+    try {
+        write_at(payload.data(), payload.size(), static_cast<size_t>(entry.sector) * kSectorSize);
+        write_at(&entry, sizeof(entry), 8 + slot * sizeof(Entry));
+    } catch (...) {
+        std::fill_n(used_sectors_.begin() + entry.sector, sectors, false);
+        throw;
+    }
+    if (old.size != 0) {
+        std::fill_n(used_sectors_.begin() + old.sector, sectors_for(old.size), false);
+    }
+    entries_[slot] = entry;
+}
+
+size_t RegionFile::file_size() const {
+    std::shared_lock lock(mutex_);
+    return used_sectors_.size() * kSectorSize;
+}
+
+size_t RegionFile::allocate(const size_t count) {
+    size_t run = 0;
+    for (size_t sector = kHeaderSectors; sector < used_sectors_.size(); sector++) {
+        run = used_sectors_[sector] ? 0 : run + 1;
+        if (run == count) {
+            const size_t first = sector + 1 - count;
+            std::fill_n(used_sectors_.begin() + first, count, true);
+            return first;
+        }
+    }
+
+    // Extend the trailing free run, if any, to the end of a grown file. The file
+    // and its mapping grow first; the bookkeeping only follows once both have
+    const size_t first = used_sectors_.size() - run;
+    const size_t size = (first + count) * kSectorSize;
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        throw io_error("Failed to grow region", path_);
+    }
+    const std::byte* grown;
+    try {
+        grown = map(size);
+    } catch (...) {
+        // Best effort: the extra sectors would only be free space on the next open
+        static_cast<void>(::ftruncate(fd_, static_cast<off_t>(used_sectors_.size() * kSectorSize)));
+        throw;
+    }
+    unmap();
+    map_ = grown;
+    map_size_ = size;
+
+    used_sectors_.resize(first + count, false);
+    std::fill_n(used_sectors_.begin() + first, count, true);
+    return first;
+}
+
+const std::byte* RegionFile::map(const size_t size) const {
+    void* address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd_, 0);
+    if (address == MAP_FAILED) {
+        throw io_error("Failed to map region", path_);
+    }
+    return static_cast<const std::byte*>(address);
+}
+
+void RegionFile::unmap() {
+    if (map_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(map_), map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+}
+
+void RegionFile::write_at(const void* data, size_t size, size_t offset) const {
+    const auto* bytes = static_cast<const std::byte*>(data);
+    while (size > 0) {
+        const ssize_t written = ::pwrite(fd_, bytes, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw io_error("Failed to write region", path_);
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<size_t>(written);
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef REGION_FILE_H
+#define REGION_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <shared_mutex>
+#include <vector>
+
+#include "Chunk.h"
+
+// One file holding a kSize^3 block of chunks.
+//
+// Layout: the file is divided into 4 KiB sectors. The first kHeaderSectors hold a
+// magic/version header followed by one {first sector, payload bytes} entry per
+// chunk (zero bytes means absent). Each payload starts on a sector boundary and
+// occupies whole sectors; its first byte selects the codec (raw blocks, or runs of
+// (count, block) pairs, whichever is smaller). All integers are little-endian.
+//
+// The file is mapped read-only, so loading a chunk decodes straight out of the page
+// cache with no read() call or intermediate buffer. Writes go through pwrite(): a
+// payload goes to the first free run of sectors, or is appended and the mapping grows
+// with the file, and only then does the table entry move to it and the old sectors
+// become free. A write interrupted partway therefore never tears a stored chunk.
+//
+// Thread-safe: concurrent reads, writes are exclusive. POSIX only.
+class RegionFile {
+public:
+    static constexpr int kSize = 16;
+    static constexpr size_t kChunkCount = static_cast<size_t>(kSize) * kSize * kSize;
+    static constexpr size_t kSectorSize = 4096;
+
+    // Opens `path`, creating an empty region if it does not exist. Throws
+    // std::runtime_error if the file cannot be opened or is not a region file.
+    explicit RegionFile(const std::filesystem::path& path);
+    ~RegionFile();
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    // Region coordinates of the region containing `chunk`, and the chunk's
+    // coordinates within it.
+    static ChunkPos region_of(const ChunkPos& chunk);
+    static ChunkPos local_of(const ChunkPos& chunk);
+
+    [[nodiscard]]
+    bool contains(const ChunkPos& local) const;
+
+    // Decodes the chunk at `local` into `chunk`. Returns false if it is absent.
+    bool read(const ChunkPos& local, DenseChunk& chunk) const;
+
+    void write(const ChunkPos& local, const DenseChunk& chunk);
+
+    [[nodiscard]]
+    size_t file_size() const;
+
+private:
+    struct Entry {
+        std::uint32_t sector;
+        std::uint32_t size;
+    };
+
+    static constexpr std::uint32_t kMagic = 0x52424941; // "AIBR"
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 8 + kChunkCount * sizeof(Entry);
+    static constexpr size_t kHeaderSectors = (kHeaderBytes + kSectorSize - 1) / kSectorSize;
+
+    static size_t index(const ChunkPos& local);
+    static size_t sectors_for(const size_t bytes) { return (bytes + kSectorSize - 1) / kSectorSize; }
+
+    // Maps the first `size` bytes of the file read-only, leaving map_ as it is.
+    const std::byte* map(size_t size) const;
+    void unmap();
+    void write_at(const void* data, size_t size, size_t offset) const;
+    // Returns the first sector of a free run of `count` sectors, growing the file if
+    // needed. Leaves the file's bookkeeping and mapping untouched when it throws.
+    size_t allocate(size_t count);
+
+    std::filesystem::path path_;
+    int fd_{-1};
+    const std::byte* map_{nullptr};
+    size_t map_size_{0};
+
+    std::vector<Entry> entries_;
+    // One flag per sector of the file
+    std::vector<bool> used_sectors_;
+    mutable std::shared_mutex mutex_;
+};
+
+#endif //REGION_FILE_H
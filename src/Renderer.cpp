@@ -0,0 +1,357 @@
+#include "Renderer.h"
+
+#include <array>
+#include <cstddef>
+#include <ranges>
+#include <vector>
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "Blocks.h"
+#include "PackedVertex.h"
+
+namespace {
+constexpr GLuint kPositionAttribute = 0;
+constexpr GLuint kColorAttribute = 1;
+// A mat4 attribute occupies four consecutive locations, one per column
+constexpr GLuint kModelAttribute = 2;
+constexpr GLuint kInstanceColorAttribute = 6;
+
+constexpr auto kVertexShader = R"(#version 330 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec4 a_color;
+layout(location = 2) in mat4 a_model;
+layout(location = 6) in vec4 a_instance_color;
+
+uniform mat4 u_view_projection;
+uniform bool u_vertex_colors;
+
+out vec4 v_color;
+
+void main() {
+    v_color = u_vertex_colors ? a_color : a_instance_color;
+    gl_Position = u_view_projection * a_model * vec4(a_position, 1.0);
+}
+)";
+
+// Decodes PackedVertex: chunk-local corner, face, ambient occlusion and block id.
+// Face shading and colors match what the meshers used to bake into float vertices.
+constexpr int kMaxPaletteSize = 64;
+static_assert(kBlockColors.size() <= kMaxPaletteSize);
+
+constexpr auto kVoxelVertexShader = R"(#version 330 core
+layout(location = 0) in uvec2 a_packed;
+layout(location = 2) in mat4 a_model;
+
+uniform mat4 u_view_projection;
+uniform vec4 u_palette[64];
+uniform int u_palette_size;
+
+const float kFaceLight[6] = float[6](0.8, 0.8, 0.5, 1.0, 0.65, 0.65);
+// Each light level below full is 80% as bright; level 0 keeps a little ambient
+const float kDarkest = 0.06;
+
+out vec4 v_color;
+
+void main() {
+    uint word = a_packed.x;
+    vec3 position = vec3(word & 63u, (word >> 6) & 63u, (word >> 12) & 63u);
+    uint face = (word >> 18) & 7u;
+    uint ao = (word >> 21) & 3u;
+    uint block = a_packed.y & 0xFFFFu;
+    uint levels = (a_packed.y >> 16) & 0xFFu;
+    float level = float(max(levels >> 4, levels & 15u));
+
+    vec4 color = block < uint(u_palette_size) ? u_palette[block] : vec4(1.0, 0.0, 1.0, 1.0);
+    float brightness = mix(kDarkest, 1.0, pow(0.8, 15.0 - level));
+    float light = kFaceLight[face] * (0.55 + 0.15 * float(ao)) * brightness;
+    v_color = vec4(color.rgb * light, color.a);
+    gl_Position = u_view_projection * a_model * vec4(position, 1.0);
+}
+)";
+
+constexpr auto kFragmentShader = R"(#version 330 core
+in vec4 v_color;
+
+out vec4 frag_color;
+
+void main() {
+    frag_color = v_color;
+}
+)";
+}
+
+Renderer::Renderer() :
+    shader_(std::make_unique<ShaderProgram>(kVertexShader, kFragmentShader)),
+    voxel_shader_(std::make_unique<ShaderProgram>(kVoxelVertexShader, kFragmentShader)) {
+    std::array<glm::vec4, kBlockColors.size()> palette;
+    for (size_t i = 0; i < palette.size(); i++) {
+        palette[i] = {kBlockColors[i].r, kBlockColors[i].g, kBlockColors[i].b, kBlockColors[i].a};
+    }
+    voxel_shader_->use();
+    voxel_shader_->set_uniform("u_palette", std::span<const glm::vec4>(palette));
+    voxel_shader_->set_uniform("u_palette_size", static_cast<int>(palette.size()));
+
+    glGenBuffers(1, &instance_buffer_);
+
+    glGenVertexArrays(1, &line_vao_);
+    glGenBuffers(1, &line_buffer_);
+
+    glBindVertexArray(line_vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, line_buffer_);
+    glEnableVertexAttribArray(kPositionAttribute);
+    glVertexAttribPointer(kPositionAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(LineVertex),
+                          reinterpret_cast<const void*>(offsetof(LineVertex, position)));
+    glEnableVertexAttribArray(kColorAttribute);
+    glVertexAttribPointer(kColorAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(LineVertex),
+                          reinterpret_cast<const void*>(offsetof(LineVertex, color)));
+    glBindVertexArray(0);
+}
+
+Renderer::~Renderer() {
+    for (auto& gpu_mesh: meshes_ | std::views::values) {
+        release(gpu_mesh);
+    }
+    glDeleteBuffers(1, &instance_buffer_);
+    glDeleteBuffers(1, &line_buffer_);
+    glDeleteVertexArrays(1, &line_vao_);
+}
+
+void Renderer::begin_frame(const glm::mat4& projection, const glm::mat4& view) {
+    ++frame_;
+    draw_calls_ = 0;
+    batch_count_ = 0;
+    instance_data_.clear();
+    view_projection_ = projection * view;
+    frustum_ = Frustum::from(view_projection_);
+    voxel_shader_->use();
+    voxel_shader_->set_uniform("u_view_projection", view_projection_);
+    shader_->use();
+    shader_->set_uniform("u_view_projection", view_projection_);
+}
+
+void Renderer::submit(const GameObject& object) {
+    if (const auto* mesh = object.get_component<MeshComponent>()) {
+        submit(*mesh, object.transform);
+    }
+}
+
+void Renderer::submit(const MeshComponent& mesh, const Transform& transform) {
+    if (!mesh.mesh || mesh.mesh->indices.empty()) {
+        return;
+    }
+
+    const glm::mat4& model = transform.matrix();
+
+    const Aabb bounds = mesh.mesh->bounds.transformed(model);
+    queued_.push_back({&mesh.mesh, {model, mesh.color}, bounds});
+    culler_.add(bounds);
+}
+
+void Renderer::add_to_batch(const MeshHandle& mesh, const InstanceData& instance) {
+    GpuMesh& gpu_mesh = acquire(mesh);
+
+    if (gpu_mesh.batch_flush != flush_) {
+        gpu_mesh.batch_flush = flush_;
+        gpu_mesh.batch = batch_count_++;
+        if (gpu_mesh.batch == batches_.size()) {
+            batches_.emplace_back();
+        }
+        // Reuse the instance vector's capacity from previous frames
+        batches_[gpu_mesh.batch].mesh = &gpu_mesh;
+        batches_[gpu_mesh.batch].instances.clear();
+    }
+    batches_[gpu_mesh.batch].instances.push_back(instance);
+}
+
+void Renderer::flush() {
+    ++flush_;
+    // Cull everything queued in one pass before any batching, upload or draw work
+    submitted_ = queued_.size();
+    occluded_ = 0;
+    if (culling_) {
+        culled_ = submitted_ - culler_.cull(frustum_, visible_);
+    } else {
+        culled_ = 0;
+        visible_.assign(submitted_, 1);
+    }
+    if (occlusion_ != nullptr) {
+        for (size_t i = 0; i < queued_.size(); i++) {
+            if (visible_[i] && !occlusion_->is_visible(queued_[i].bounds)) {
+                visible_[i] = 0;
+                ++occluded_;
+            }
+        }
+        culled_ += occluded_;
+    }
+    for (size_t i = 0; i < queued_.size(); i++) {
+        if (visible_[i]) {
+            add_to_batch(*queued_[i].mesh, queued_[i].instance);
+        } else if (const auto it = meshes_.find(queued_[i].mesh->get()); it != meshes_.end()) {
+            // Off screen but still in the scene: keep the buffers so turning around does not re-upload
+            it->second.last_used_frame = frame_;
+        }
+    }
+    queued_.clear();
+    culler_.clear();
+
+    // Pack every batch into one contiguous buffer so the frame costs a single upload
+    size_t total_instances = 0;
+    for (size_t i = 0; i < batch_count_; i++) {
+        total_instances += batches_[i].instances.size();
+    }
+    instance_data_.clear();
+    instance_data_.reserve(total_instances);
+    for (size_t i = 0; i < batch_count_; i++) {
+        instance_data_.insert(instance_data_.end(), batches_[i].instances.begin(), batches_[i].instances.end());
+    }
+    if (instance_data_.empty()) {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+    // Orphan the previous contents so the driver does not stall on in-flight draws
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instance_data_.size() * sizeof(InstanceData)),
+                 instance_data_.data(), GL_STREAM_DRAW);
+
+    size_t first_instance = 0;
+    const ShaderProgram* current = nullptr;
+    for (size_t i = 0; i < batch_count_; i++) {
+        const Batch& batch = batches_[i];
+        ShaderProgram& program = batch.mesh->packed ? *voxel_shader_ : *shader_;
+        if (&program != current) {
+            program.use();
+            current = &program;
+        }
+        if (!batch.mesh->packed) {
+            shader_->set_uniform("u_vertex_colors", batch.mesh->has_vertex_colors ? 1 : 0);
+        }
+
+        glBindVertexArray(batch.mesh->vao);
+        // Attribute pointers are VAO state, so each batch points them at its own slice
+        bind_instance_attributes(first_instance);
+        glDrawElementsInstanced(GL_TRIANGLES, batch.mesh->index_count, GL_UNSIGNED_INT, nullptr,
+                                static_cast<GLsizei>(batch.instances.size()));
+        ++draw_calls_;
+        first_instance += batch.instances.size();
+    }
+    glBindVertexArray(0);
+    batch_count_ = 0;
+}
+
+void Renderer::draw_lines(const std::span<const LineVertex> vertices) {
+    if (vertices.empty()) {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, line_buffer_);
+    // Orphan the previous contents so the driver does not stall on in-flight draws
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size_bytes()), vertices.data(), GL_STREAM_DRAW);
+
+    shader_->use();
+    shader_->set_uniform("u_vertex_colors", 1);
+    // The line VAO has no instance attributes, so the model matrix comes from the
+    // current generic attribute values: identity
+    for (GLuint column = 0; column < 4; column++) {
+        glVertexAttrib4f(kModelAttribute + column,
+                         column == 0 ? 1.0f : 0.0f, column == 1 ? 1.0f : 0.0f,
+                         column == 2 ? 1.0f : 0.0f, column == 3 ? 1.0f : 0.0f);
+    }
+    glBindVertexArray(line_vao_);
+    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size()));
+    glBindVertexArray(0);
+    ++draw_calls_;
+}
+
+void Renderer::end_frame() {
+    for (auto it = meshes_.begin(); it != meshes_.end();) {
+        if (!it->second.source.expired() && frame_ - it->second.last_used_frame < kEvictAfterFrames) {
+            ++it;
+            continue;
+        }
+        release(it->second);
+        it = meshes_.erase(it);
+    }
+}
+
+Renderer::GpuMesh& Renderer::acquire(const MeshHandle& mesh) {
+    auto [it, inserted] = meshes_.try_emplace(mesh.get());
+    GpuMesh& gpu_mesh = it->second;
+    if (!inserted && gpu_mesh.source.expired()) {
+        // A freed mesh's address was reused by new geometry before eviction ran
+        release(gpu_mesh);
+        inserted = true;
+    }
+    if (inserted) {
+        glGenVertexArrays(1, &gpu_mesh.vao);
+        glGenBuffers(1, &gpu_mesh.vertex_buffer);
+        glGenBuffers(1, &gpu_mesh.index_buffer);
+        upload(gpu_mesh, *mesh);
+        gpu_mesh.source = mesh;
+    }
+    gpu_mesh.last_used_frame = frame_;
+    return gpu_mesh;
+}
+
+void Renderer::upload(GpuMesh& gpu_mesh, const MeshData& mesh) const {
+    glBindVertexArray(gpu_mesh.vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, gpu_mesh.vertex_buffer);
+    gpu_mesh.packed = !mesh.packed.empty();
+    if (gpu_mesh.packed) {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.packed.size() * sizeof(PackedVertex)),
+                     mesh.packed.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(kPositionAttribute);
+        // Integer attribute: the voxel shader unpacks the bits itself
+        glVertexAttribIPointer(kPositionAttribute, 2, GL_UNSIGNED_INT, sizeof(PackedVertex), nullptr);
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.vertices.size() * sizeof(glm::vec3)),
+                     mesh.vertices.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(kPositionAttribute);
+        glVertexAttribPointer(kPositionAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+    }
+
+    gpu_mesh.has_vertex_colors = !mesh.colors.empty();
+    if (gpu_mesh.has_vertex_colors) {
+        glGenBuffers(1, &gpu_mesh.color_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, gpu_mesh.color_buffer);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.colors.size() * sizeof(Color)),
+                     mesh.colors.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(kColorAttribute);
+        glVertexAttribPointer(kColorAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(Color), nullptr);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instance_buffer_);
+    for (GLuint column = 0; column < 4; column++) {
+        glEnableVertexAttribArray(kModelAttribute + column);
+        glVertexAttribDivisor(kModelAttribute + column, 1);
+    }
+    glEnableVertexAttribArray(kInstanceColorAttribute);
+    glVertexAttribDivisor(kInstanceColorAttribute, 1);
+
+    // The element buffer binding is part of the VAO state
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu_mesh.index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(mesh.indices.size() * sizeof(unsigned int)),
+                 mesh.indices.data(), GL_STATIC_DRAW);
+    gpu_mesh.index_count = static_cast<GLsizei>(mesh.indices.size());
+
+    glBindVertexArray(0);
+}
+
+void Renderer::bind_instance_attributes(const size_t first_instance) {
+    const size_t base = first_instance * sizeof(InstanceData);
+    for (GLuint column = 0; column < 4; column++) {
+        glVertexAttribPointer(kModelAttribute + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              reinterpret_cast<const void*>(base + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(kInstanceColorAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          reinterpret_cast<const void*>(base + offsetof(InstanceData, color)));
+}
+
+void Renderer::release(GpuMesh& gpu_mesh) {
+    glDeleteBuffers(1, &gpu_mesh.vertex_buffer);
+    if (gpu_mesh.color_buffer != 0) {
+        glDeleteBuffers(1, &gpu_mesh.color_buffer);
+    }
+    glDeleteBuffers(1, &gpu_mesh.index_buffer);
+    glDeleteVertexArrays(1, &gpu_mesh.vao);
+    gpu_mesh = {};
+}
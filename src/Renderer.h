@@ -0,0 +1,165 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <GLFW/glfw3.h>
+
+#include "glm/glm.hpp"
+#include "Color.h"
+#include "Frustum.h"
+#include "GameObject.h"
+#include "MeshComponent.h"
+#include "MeshRegistry.h"
+#include "OcclusionCuller.h"
+#include "ShaderProgram.h"
+#include "Transform.h"
+
+struct LineVertex {
+    glm::vec3 position;
+    Color color;
+};
+
+// Retained-mode renderer. Each MeshData is uploaded into a VAO/VBO/IBO the first
+// time it is submitted; since mesh data is immutable it is never re-uploaded.
+//
+// Submitted objects are batched by mesh handle: components sharing geometry from
+// the MeshRegistry share one set of GPU buffers and are drawn with a single instanced call,
+// with per-instance transforms streamed from one packed buffer per frame. The draw
+// call count therefore grows with the number of distinct meshes, not objects.
+// Voxel meshes in the PackedVertex format go through a second program that
+// decodes them on the GPU.
+//
+// Requires a current OpenGL 3.3 core context for its whole lifetime.
+class Renderer {
+public:
+    Renderer();
+    ~Renderer();
+
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    void begin_frame(const glm::mat4& projection, const glm::mat4& view);
+
+    // Queues the object's MeshComponent, if it has one, for the next flush(). The
+    // component must stay alive until then.
+    void submit(const GameObject& object);
+    void submit(const MeshComponent& mesh, const Transform& transform);
+
+    // Culls the queued objects against the view frustum, then uploads the instance
+    // data of the visible ones and draws every batch.
+    void flush();
+
+    // Frustum culling can be turned off for comparison; on by default.
+    void set_culling(const bool enabled) { culling_ = enabled; }
+
+    [[nodiscard]]
+    bool culling() const { return culling_; }
+
+    // Objects that pass the frustum test are also tested against `occlusion`, which
+    // must have been rasterized for this frame. nullptr disables occlusion culling.
+    void set_occlusion_culler(const OcclusionCuller* occlusion) { occlusion_ = occlusion; }
+
+    // Draws a GL_LINES list in world space. Intended for debug geometry.
+    void draw_lines(std::span<const LineVertex> vertices);
+
+    // Releases GPU buffers of meshes that were freed or not drawn for a while.
+    void end_frame();
+
+    [[nodiscard]]
+    size_t draw_calls() const { return draw_calls_; }
+
+    [[nodiscard]]
+    size_t resident_meshes() const { return meshes_.size(); }
+
+    [[nodiscard]]
+    size_t instances() const { return instance_data_.size(); }
+
+    // Objects submitted and culled during the last flush().
+    [[nodiscard]]
+    size_t submitted() const { return submitted_; }
+
+    [[nodiscard]]
+    size_t culled() const { return culled_; }
+
+    // Of the culled objects, those hidden behind occluders rather than off screen.
+    [[nodiscard]]
+    size_t occluded() const { return occluded_; }
+
+private:
+    struct InstanceData {
+        glm::mat4 model;
+        Color color;
+    };
+
+    struct GpuMesh {
+        GLuint vao{0};
+        GLuint vertex_buffer{0};
+        GLuint color_buffer{0};
+        GLuint index_buffer{0};
+        GLsizei index_count{0};
+        bool has_vertex_colors{false};
+        // PackedVertex geometry, drawn with the voxel shader
+        bool packed{false};
+        // Detects the MeshData being freed, and its address being reused
+        std::weak_ptr<const MeshData> source;
+        std::uint64_t last_used_frame{0};
+        // Index into batches_, valid when batch_flush equals flush_
+        size_t batch{0};
+        std::uint64_t batch_flush{0};
+    };
+
+    struct Batch {
+        GpuMesh* mesh{nullptr};
+        std::vector<InstanceData> instances;
+    };
+
+    // An object waiting for flush(); its bounds are at the same index in culler_.
+    struct Queued {
+        const MeshHandle* mesh;
+        InstanceData instance;
+        Aabb bounds;
+    };
+
+    // Meshes not drawn for this many frames have their buffers deleted.
+    static constexpr std::uint64_t kEvictAfterFrames = 120;
+
+    void add_to_batch(const MeshHandle& mesh, const InstanceData& instance);
+    GpuMesh& acquire(const MeshHandle& mesh);
+    void upload(GpuMesh& gpu_mesh, const MeshData& mesh) const;
+    static void release(GpuMesh& gpu_mesh);
+    static void bind_instance_attributes(size_t first_instance);
+
+    std::unique_ptr<ShaderProgram> shader_;
+    std::unique_ptr<ShaderProgram> voxel_shader_;
+    std::unordered_map<const MeshData*, GpuMesh> meshes_;
+
+    std::vector<Queued> queued_;
+    FrustumCuller culler_;
+    std::vector<std::uint8_t> visible_;
+    bool culling_{true};
+    const OcclusionCuller* occlusion_{nullptr};
+
+    std::vector<Batch> batches_;
+    size_t batch_count_{0};
+    std::vector<InstanceData> instance_data_;
+    GLuint instance_buffer_{0};
+
+    GLuint line_vao_{0};
+    GLuint line_buffer_{0};
+
+    glm::mat4 view_projection_{1.0f};
+    Frustum frustum_;
+    std::uint64_t frame_{0};
+    // Counts flush() calls, of which a frame may have several; batches are per flush
+    std::uint64_t flush_{0};
+    size_t draw_calls_{0};
+    size_t submitted_{0};
+    size_t culled_{0};
+    size_t occluded_{0};
+};
+
+#endif //RENDERER_H
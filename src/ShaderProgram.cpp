@@ -0,0 +1,102 @@
+#include "ShaderProgram.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+namespace {
+GLuint compile_shader(const GLenum type, const char* source) {
+    const GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<size_t>(length), '\0');
+        glGetShaderInfoLog(shader, length, nullptr, log.data());
+        glDeleteShader(shader);
+        throw std::runtime_error("Failed to compile shader: " + log);
+    }
+    return shader;
+}
+}
+
+ShaderProgram::ShaderProgram(const char* vertex_source, const char* fragment_source) {
+    const GLuint vertex_shader = compile_shader(GL_VERTEX_SHADER, vertex_source);
+    GLuint fragment_shader;
+    try {
+        fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+    } catch (...) {
+        glDeleteShader(vertex_shader);
+        throw;
+    }
+
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertex_shader);
+    glAttachShader(program_, fragment_shader);
+    glLinkProgram(program_);
+
+    // The program keeps the compiled stages alive for as long as it needs them
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        GLint length = 0;
+        glGetProgramiv(program_, GL_INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<size_t>(length), '\0');
+        glGetProgramInfoLog(program_, length, nullptr, log.data());
+        glDeleteProgram(program_);
+        throw std::runtime_error("Failed to link shader program: " + log);
+    }
+}
+
+ShaderProgram::~ShaderProgram() {
+    glDeleteProgram(program_);
+}
+
+void ShaderProgram::use() const {
+    glUseProgram(program_);
+}
+
+GLint ShaderProgram::uniform_location(const char* name) {
+    if (const auto it = uniform_locations_.find(name); it != uniform_locations_.end()) {
+        return it->second;
+    }
+    const GLint location = glGetUniformLocation(program_, name);
+    uniform_locations_.emplace(name, location);
+    return location;
+}
+
+void ShaderProgram::set_uniform(const char* name, const glm::mat4& value) {
+    glUniformMatrix4fv(uniform_location(name), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void ShaderProgram::set_uniform(const char* name, const glm::vec4& value) {
+    glUniform4fv(uniform_location(name), 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::set_uniform(const char* name, const std::span<const glm::vec4> values) {
+    if (values.empty()) {
+        return;
+    }
+    glUniform4fv(uniform_location(name), static_cast<GLsizei>(values.size()), glm::value_ptr(values.front()));
+}
+
+void ShaderProgram::set_uniform(const char* name, const glm::vec3& value) {
+    glUniform3fv(uniform_location(name), 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::set_uniform(const char* name, const float value) {
+    glUniform1f(uniform_location(name), value);
+}
+
+void ShaderProgram::set_uniform(const char* name, const int value) {
+    glUniform1i(uniform_location(name), value);
+}
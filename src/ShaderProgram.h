@@ -0,0 +1,41 @@
+#ifndef SHADER_PROGRAM_H
+#define SHADER_PROGRAM_H
+
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <GLFW/glfw3.h>
+
+#include "glm/fwd.hpp"
+
+// Owns a linked vertex + fragment shader pair. Requires a current OpenGL context
+// for its whole lifetime.
+class ShaderProgram {
+public:
+    ShaderProgram(const char* vertex_source, const char* fragment_source);
+    ~ShaderProgram();
+
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    void use() const;
+
+    void set_uniform(const char* name, const glm::mat4& value);
+    void set_uniform(const char* name, const glm::vec4& value);
+    // Sets a vec4 array uniform starting at element 0.
+    void set_uniform(const char* name, std::span<const glm::vec4> values);
+    void set_uniform(const char* name, const glm::vec3& value);
+    void set_uniform(const char* name, float value);
+    void set_uniform(const char* name, int value);
+
+    [[nodiscard]]
+    GLuint id() const { return program_; }
+
+private:
+    GLint uniform_location(const char* name);
+
+    GLuint program_{0};
+    std::unordered_map<std::string, GLint> uniform_locations_;
+};
+
+#endif //SHADER_PROGRAM_H
@@ -0,0 +1,293 @@
+#include "SparseVoxelOctree.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+bool overlaps(const glm::ivec3& cube_min, const int cube_size, const glm::ivec3& min, const glm::ivec3& max) {
+    return cube_min.x < max.x && cube_min.y < max.y && cube_min.z < max.z
+        && cube_min.x + cube_size > min.x && cube_min.y + cube_size > min.y && cube_min.z + cube_size > min.z;
+}
+
+bool covers(const glm::ivec3& cube_min, const int cube_size, const glm::ivec3& min, const glm::ivec3& max) {
+    return cube_min.x >= min.x && cube_min.y >= min.y && cube_min.z >= min.z
+        && cube_min.x + cube_size <= max.x && cube_min.y + cube_size <= max.y && cube_min.z + cube_size <= max.z;
+}
+}
+
+SparseVoxelOctree::SparseVoxelOctree(const int depth, const glm::ivec3& origin, const BlockId fill)
+    : depth_(depth), origin_(origin), root_(leaf(fill)) {
+    if (depth < 0 || depth > kMaxDepth) {
+        throw std::runtime_error("Octree depth out of range: " + std::to_string(depth));
+    }
+}
+
+BlockId SparseVoxelOctree::get(const int x, const int y, const int z) const {
+    const glm::ivec3 p = glm::ivec3(x, y, z) - origin_;
+    if (!contains_local(p)) {
+        return kAir;
+    }
+    Slot slot = root_;
+    for (int half = size() / 2; !is_leaf(slot); half /= 2) {
+        slot = nodes_[slot][child_index(p, half)];
+    }
+    return leaf_block(slot);
+}
+
+void SparseVoxelOctree::set(const int x, const int y, const int z, const BlockId block) {
+    const glm::ivec3 p = glm::ivec3(x, y, z) - origin_;
+    if (contains_local(p)) {
+        replace(p, 1, leaf(block));
+    }
+}
+
+void SparseVoxelOctree::fill(const glm::ivec3& min, const glm::ivec3& max, const BlockId block) {
+    root_ = fill(root_, glm::ivec3(0), size(), min - origin_, max - origin_, block);
+}
+
+std::optional<BlockId> SparseVoxelOctree::uniform(const glm::ivec3& min, const glm::ivec3& max) const {
+    const glm::ivec3 local_min = min - origin_;
+    const glm::ivec3 local_max = max - origin_;
+    std::optional<BlockId> value;
+    if (local_min.x < 0 || local_min.y < 0 || local_min.z < 0
+        || local_max.x > size() || local_max.y > size() || local_max.z > size()) {
+        // Part of the box is outside the tree, which reads as air
+        value = kAir;
+    }
+    if (!uniform(root_, glm::ivec3(0), size(), local_min, local_max, value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+void SparseVoxelOctree::write_chunk(const ChunkPos& position, const DenseChunk& chunk) {
+    const glm::ivec3 p = position * kChunkSize - origin_;
+    if (size() < kChunkSize || p.x % kChunkSize != 0 || p.y % kChunkSize != 0 || p.z % kChunkSize != 0
+        || !contains_local(p)) {
+        throw std::runtime_error("Chunk (" + std::to_string(position.x) + ", " + std::to_string(position.y) + ", "
+                                 + std::to_string(position.z) + ") is not an aligned part of the octree");
+    }
+    replace(p, kChunkSize, build(chunk));
+}
+
+void SparseVoxelOctree::read_chunk(const ChunkPos& position, DenseChunk& chunk) const {
+    const glm::ivec3 p = position * kChunkSize - origin_;
+    if (size() < kChunkSize || p.x % kChunkSize != 0 || p.y % kChunkSize != 0 || p.z % kChunkSize != 0
+        || !contains_local(p)) {
+        // Straddles the tree's edge: no single subtree holds it
+        const glm::ivec3 base = position * kChunkSize;
+        for (int y = 0; y < kChunkSize; y++) {
+            for (int z = 0; z < kChunkSize; z++) {
+                for (int x = 0; x < kChunkSize; x++) {
+                    chunk.set(x, y, z, get(base.x + x, base.y + y, base.z + z));
+                }
+            }
+        }
+        return;
+    }
+    Slot slot = root_;
+    for (int half = size() / 2; half >= kChunkSize && !is_leaf(slot); half /= 2) {
+        slot = nodes_[slot][child_index(p, half)];
+    }
+    copy_out(slot, chunk);
+}
+
+SparseVoxelOctree::Slot SparseVoxelOctree::allocate(const Slot fill_slot) {
+    Slot node;
+    if (!free_.empty()) {
+        node = free_.back();
+        free_.pop_back();
+    } else {
+        if (nodes_.size() >= kLeafBit) {
+            throw std::runtime_error("Octree node pool exhausted");
+        }
+        node = static_cast<Slot>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    nodes_[node].fill(fill_slot);
+    return node;
+}
+
+void SparseVoxelOctree::release(const Slot slot) {
+    if (is_leaf(slot)) {
+        return;
+    }
+    for (const Slot child: nodes_[slot]) {
+        release(child);
+    }
+    free_.push_back(slot);
+}
+
+std::optional<SparseVoxelOctree::Slot> SparseVoxelOctree::collapsed(const Slot node) const {
+    const Node& children = nodes_[node];
+    if (!is_leaf(children[0]) || !std::ranges::all_of(children, [&](const Slot child) { return child == children[0]; })) {
+        return std::nullopt;
+    }
+    return children[0];
+}
+
+void SparseVoxelOctree::replace(const glm::ivec3& p, const int cube_size, const Slot value) {
+    // Nodes on the way down, with the child taken in each
+    std::array<std::pair<Slot, int>, kMaxDepth> path;
+    int length = 0;
+    // The slot being descended: root_ while length is 0, else a child of path[length - 1]
+    const auto slot = [&]() -> Slot& {
+        return length == 0 ? root_ : nodes_[path[length - 1].first][path[length - 1].second];
+    };
+
+    for (int half = size() / 2; half >= cube_size; half /= 2) {
+        if (is_leaf(slot())) {
+            if (slot() == value) {
+                return; // already that value
+            }
+            const Slot node = allocate(slot());
+            slot() = node;
+        }
+        path[length] = {slot(), child_index(p, half)};
+        length++;
+    }
+    release(slot());
+    slot() = value;
+
+    // Merge nodes whose children all became the same leaf, bottom up
+    while (length > 0) {
+        const Slot node = path[length - 1].first;
+        const std::optional<Slot> merged = collapsed(node);
+        if (!merged) {
+            break;
+        }
+        free_.push_back(node);
+        length--;
+        slot() = *merged;
+    }
+}
+
+SparseVoxelOctree::Slot SparseVoxelOctree::fill(Slot slot, const glm::ivec3& cube_min, const int cube_size,
+                                                const glm::ivec3& min, const glm::ivec3& max, const BlockId block) {
+    if (!overlaps(cube_min, cube_size, min, max)) {
+        return slot;
+    }
+    if (covers(cube_min, cube_size, min, max)) {
+        release(slot);
+        return leaf(block);
+    }
+    if (is_leaf(slot)) {
+        if (leaf_block(slot) == block) {
+            return slot;
+        }
+        slot = allocate(slot);
+    }
+    const int half = cube_size / 2;
+    for (int child = 0; child < 8; child++) {
+        // The pool may grow during the call, so index it again afterwards
+        const Slot updated = fill(nodes_[slot][child], cube_min + child_offset(child, half), half, min, max, block);
+        nodes_[slot][child] = updated;
+    }
+    if (const std::optional<Slot> merged = collapsed(slot)) {
+        free_.push_back(slot);
+        return *merged;
+    }
+    return slot;
+}
+
+bool SparseVoxelOctree::uniform(const Slot slot, const glm::ivec3& cube_min, const int cube_size,
+                                const glm::ivec3& min, const glm::ivec3& max, std::optional<BlockId>& value) const {
+    if (!overlaps(cube_min, cube_size, min, max)) {
+        return true;
+    }
+    if (is_leaf(slot)) {
+        if (!value) {
+            value = leaf_block(slot);
+        }
+        return *value == leaf_block(slot);
+    }
+    const int half = cube_size / 2;
+    for (int child = 0; child < 8; child++) {
+        if (!uniform(nodes_[slot][child], cube_min + child_offset(child, half), half, min, max, value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SparseVoxelOctree::Slot SparseVoxelOctree::build(const DenseChunk& chunk) {
+    // Bottom up, one level of the chunk's subtree at a time: `cells` holds the
+    // slots of an n^3 grid (x fastest, then z, then y), starting with the blocks
+    std::vector<Slot> cells(DenseChunk::kVolume);
+    size_t i = 0;
+    for (int y = 0; y < kChunkSize; y++) {
+        for (int z = 0; z < kChunkSize; z++) {
+            for (int x = 0; x < kChunkSize; x++, i++) {
+                cells[i] = leaf(chunk.get(x, y, z));
+            }
+        }
+    }
+
+    std::vector<Slot> parents;
+    for (int n = kChunkSize; n > 1; n /= 2) {
+        const int half = n / 2;
+        parents.resize(static_cast<size_t>(half) * half * half);
+        size_t parent = 0;
+        for (int y = 0; y < half; y++) {
+            for (int z = 0; z < half; z++) {
+                for (int x = 0; x < half; x++, parent++) {
+                    // Child bit 0 steps along x, bit 1 along y and bit 2 along z
+                    const size_t row = static_cast<size_t>(n);
+                    const size_t first = (static_cast<size_t>(y) * 2 * row + static_cast<size_t>(z) * 2) * row
+                        + static_cast<size_t>(x) * 2;
+                    Node children;
+                    for (int child = 0; child < 8; child++) {
+                        children[child] = cells[first + (child & 1) + (child & 2 ? row * row : 0) + (child & 4 ? row : 0)];
+                    }
+                    if (is_leaf(children[0])
+                        && std::ranges::all_of(children, [&](const Slot child) { return child == children[0]; })) {
+                        parents[parent] = children[0];
+                    } else {
+                        const Slot node = allocate(0);
+                        nodes_[node] = children;
+                        parents[parent] = node;
+                    }
+                }
+            }
+        }
+        std::swap(cells, parents);
+    }
+    return cells[0];
+}
+
+void SparseVoxelOctree::copy_out(const Slot slot, DenseChunk& chunk) const {
+    if (is_leaf(slot)) {
+        chunk.fill(leaf_block(slot));
+        return;
+    }
+    // Top down, the reverse of build(): expand the grid of slots one level at a
+    // time; leaves stand in for all of their cells
+    std::vector<Slot> cells{slot};
+    std::vector<Slot> children;
+    for (int n = 1; n < kChunkSize; n *= 2) {
+        const int size = n * 2;
+        children.resize(static_cast<size_t>(size) * size * size);
+        size_t i = 0;
+        for (int y = 0; y < size; y++) {
+            for (int z = 0; z < size; z++) {
+                for (int x = 0; x < size; x++, i++) {
+                    const Slot parent = cells[(static_cast<size_t>(y / 2) * n + z / 2) * n + x / 2];
+                    children[i] = is_leaf(parent)
+                        ? parent
+                        : nodes_[parent][(x & 1) | (y & 1) << 1 | (z & 1) << 2];
+                }
+            }
+        }
+        std::swap(cells, children);
+    }
+    size_t i = 0;
+    for (int y = 0; y < kChunkSize; y++) {
+        for (int z = 0; z < kChunkSize; z++) {
+            for (int x = 0; x < kChunkSize; x++, i++) {
+                chunk.set(x, y, z, leaf_block(cells[i]));
+            }
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#ifndef SPARSE_VOXEL_OCTREE_H
+#define SPARSE_VOXEL_OCTREE_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Chunk.h"
+
+// Block storage for a whole world as a sparse octree. Any cube of blocks that
+// holds a single value is one leaf however large it is, so air above the terrain
+// and solid rock below it cost next to nothing; only the surface is stored at
+// full resolution.
+//
+// Nodes live in one pooled array, eight child slots each. A slot holds either a
+// leaf (kLeafBit | block id) or the index of a child node. Writes split leaves on
+// the way down and collapse nodes whose children became one leaf on the way back
+// up, so the tree stays minimal; freed nodes are reused by later splits.
+//
+// The tree covers a cube of 2^depth blocks per axis starting at `origin` (in
+// block coordinates); reads outside it return air and writes there are ignored.
+// Chunks convert to and from it with write_chunk() and read_chunk(), for meshing.
+//
+// Not thread-safe for writes; concurrent reads are fine.
+class SparseVoxelOctree {
+public:
+    // Depths past this would overflow int block coordinates.
+    static constexpr int kMaxDepth = 24;
+
+    // Throws std::runtime_error unless depth is in [0, kMaxDepth].
+    explicit SparseVoxelOctree(int depth, const glm::ivec3& origin = glm::ivec3(0), BlockId fill = kAir);
+
+    [[nodiscard]]
+    BlockId get(int x, int y, int z) const;
+
+    [[nodiscard]]
+    BlockId get(const glm::ivec3& p) const { return get(p.x, p.y, p.z); }
+
+    void set(int x, int y, int z, BlockId block);
+
+    void set(const glm::ivec3& p, const BlockId block) { set(p.x, p.y, p.z, block); }
+
+    // Sets every block in [min, max) at once, replacing whole subtrees where the
+    // box covers them.
+    void fill(const glm::ivec3& min, const glm::ivec3& max, BlockId block);
+
+    // The block filling all of [min, max), or nothing if it holds several. Blocks
+    // outside the tree count as air.
+    [[nodiscard]]
+    std::optional<BlockId> uniform(const glm::ivec3& min, const glm::ivec3& max) const;
+
+    // Calls fn(const glm::ivec3& min, int size, BlockId block) for every leaf cube
+    // overlapping [min, max); cubes are not clipped to the box.
+    template<typename Fn>
+    void for_each_leaf(const glm::ivec3& min, const glm::ivec3& max, Fn&& fn) const {
+        for_each_leaf(root_, origin_, size(), min, max, fn);
+    }
+
+    // Replaces the blocks of chunk `position` (chunk p spans p * kChunkSize to
+    // (p + 1) * kChunkSize). Throws std::runtime_error if the chunk is not inside
+    // the tree.
+    void write_chunk(const ChunkPos& position, const DenseChunk& chunk);
+
+    // Copies the blocks of chunk `position` into `chunk`; air outside the tree.
+    void read_chunk(const ChunkPos& position, DenseChunk& chunk) const;
+
+    [[nodiscard]]
+    int depth() const { return depth_; }
+
+    // Blocks per axis.
+    [[nodiscard]]
+    int size() const { return 1 << depth_; }
+
+    [[nodiscard]]
+    const glm::ivec3& origin() const { return origin_; }
+
+    // Nodes in use, not counting freed ones kept for reuse.
+    [[nodiscard]]
+    size_t node_count() const { return nodes_.size() - free_.size(); }
+
+    // Heap plus inline bytes held by the tree.
+    [[nodiscard]]
+    size_t memory_usage() const {
+        return sizeof(*this) + nodes_.capacity() * sizeof(Node) + free_.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+    using Slot = std::uint32_t;
+    using Node = std::array<Slot, 8>;
+
+    static constexpr Slot kLeafBit = 0x80000000u;
+
+    static constexpr Slot leaf(const BlockId block) { return kLeafBit | block; }
+    static constexpr bool is_leaf(const Slot slot) { return (slot & kLeafBit) != 0; }
+    static constexpr BlockId leaf_block(const Slot slot) { return static_cast<BlockId>(slot & 0xFFFFu); }
+
+    // Child containing local coordinate p of the aligned cube of 2 * half blocks around it.
+    static constexpr int child_index(const glm::ivec3& p, const int half) {
+        return (p.x & half ? 1 : 0) | (p.y & half ? 2 : 0) | (p.z & half ? 4 : 0);
+    }
+
+    static constexpr glm::ivec3 child_offset(const int child, const int half) {
+        return {child & 1 ? half : 0, child & 2 ? half : 0, child & 4 ? half : 0};
+    }
+
+    [[nodiscard]]
+    bool contains_local(const glm::ivec3& p) const {
+        return p.x >= 0 && p.y >= 0 && p.z >= 0 && p.x < size() && p.y < size() && p.z < size();
+    }
+
+    // A node whose eight children are `fill_slot`.
+    Slot allocate(Slot fill_slot);
+    // Frees the subtree under `slot`.
+    void release(Slot slot);
+    // Returns the leaf the node's children all are, if they are.
+    [[nodiscard]]
+    std::optional<Slot> collapsed(Slot node) const;
+
+    // Stores `value` as the subtree of the aligned cube of `cube_size` blocks at
+    // local coordinate `p`, splitting leaves above it and collapsing afterwards.
+    void replace(const glm::ivec3& p, int cube_size, Slot value);
+    Slot fill(Slot slot, const glm::ivec3& cube_min, int cube_size, const glm::ivec3& min, const glm::ivec3& max,
+              BlockId block);
+    // False once the leaves overlapping [min, max) disagree with `value`.
+    bool uniform(Slot slot, const glm::ivec3& cube_min, int cube_size, const glm::ivec3& min, const glm::ivec3& max,
+                 std::optional<BlockId>& value) const;
+    // Subtree of a whole chunk, collapsed.
+    Slot build(const DenseChunk& chunk);
+    // Expands the subtree of a whole chunk into `chunk`.
+    void copy_out(Slot slot, DenseChunk& chunk) const;
+
+    template<typename Fn>
+    void for_each_leaf(const Slot slot, const glm::ivec3& cube_min, const int cube_size,
+                       const glm::ivec3& min, const glm::ivec3& max, Fn& fn) const {
+        if (cube_min.x >= max.x || cube_min.y >= max.y || cube_min.z >= max.z
+            || cube_min.x + cube_size <= min.x || cube_min.y + cube_size <= min.y || cube_min.z + cube_size <= min.z) {
+            return;
+        }
+        if (is_leaf(slot)) {
+            fn(cube_min, cube_size, leaf_block(slot));
+            return;
+        }
+        const int half = cube_size / 2;
+        for (int child = 0; child < 8; child++) {
+            for_each_leaf(nodes_[slot][child], cube_min + child_offset(child, half), half, min, max, fn);
+        }
+    }
+
+    int depth_;
+    glm::ivec3 origin_;
+    Slot root_;
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> free_;
+};
+
+#endif //SPARSE_VOXEL_OCTREE_H
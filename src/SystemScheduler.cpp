@@ -0,0 +1,99 @@
+#include "SystemScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+void SystemScheduler::add(std::string name, const Access& access, System system) {
+    const size_t index = systems_.size();
+    Entry entry{std::move(name), access, std::move(system), {}, 0, 0.0};
+    for (size_t i = 0; i < index; i++) {
+        if (systems_[i].access.conflicts_with(access)) {
+            systems_[i].dependents.push_back(index);
+            entry.dependencies++;
+        }
+    }
+    systems_.push_back(std::move(entry));
+}
+
+void SystemScheduler::run(const float delta_time) {
+    const auto start = std::chrono::steady_clock::now();
+
+    auto run = std::make_shared<Run>();
+    run->delta_time = delta_time;
+    run->remaining = systems_.size();
+    for (size_t i = 0; i < systems_.size(); i++) {
+        run->unmet.push_back(systems_[i].dependencies);
+        if (systems_[i].dependencies == 0) {
+            run->ready.push_back(i);
+        }
+    }
+
+    // One of the initially ready systems stays on this thread
+    help(run, run->ready.empty() ? 0 : run->ready.size() - 1);
+
+    std::unique_lock lock(run->mutex);
+    while (run->remaining > 0) {
+        drain(run, lock);
+        if (run->remaining > 0) {
+            // Everything left is running elsewhere or waiting on something that is
+            run->changed.wait(lock);
+        }
+    }
+    lock.unlock();
+    last_run_us_ = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    if (run->error) {
+        std::rethrow_exception(run->error);
+    }
+}
+
+void SystemScheduler::help(const std::shared_ptr<Run>& run, const size_t count) {
+    for (size_t i = 0; i < std::min(count, jobs_.worker_count()); i++) {
+        jobs_.submit([this, run] {
+            std::unique_lock lock(run->mutex);
+            // Late helpers find nothing ready and never touch `this`
+            drain(run, lock);
+        }, JobSystem::Priority::High);
+    }
+}
+
+void SystemScheduler::drain(const std::shared_ptr<Run>& shared, std::unique_lock<std::mutex>& lock) {
+    Run& run = *shared;
+    while (!run.ready.empty()) {
+        const size_t index = run.ready.back();
+        run.ready.pop_back();
+        lock.unlock();
+
+        Entry& entry = systems_[index];
+        const auto start = std::chrono::steady_clock::now();
+        std::exception_ptr error;
+        try {
+            entry.system(run.delta_time);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        entry.time_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        if (error && !run.error) {
+            run.error = error;
+        }
+        size_t released = 0;
+        for (const size_t dependent: entry.dependents) {
+            if (--run.unmet[dependent] == 0) {
+                run.ready.push_back(dependent);
+                released++;
+            }
+        }
+        run.remaining--;
+        run.changed.notify_all();
+
+        if (released > 1) {
+            // This thread continues with one of them
+            lock.unlock();
+            help(shared, released - 1);
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef SYSTEM_SCHEDULER_H
+#define SYSTEM_SCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ComponentType.h"
+#include "JobSystem.h"
+
+// Runs the per-frame update phase: a list of systems, each declaring which types
+// it reads and writes. Systems whose access conflicts (one writes what the other
+// reads or writes) run in the order they were added; all others may run at the
+// same time on the JobSystem. The calling thread takes part and run() returns
+// once every system has finished, so systems can touch state owned by the
+// calling thread as long as their declared access keeps them apart.
+//
+// Access is declared per type, through ecs::component_type<T>(), so it can name
+// components (Transform) as well as whole objects used as resources (ChunkStreamer).
+class SystemScheduler {
+public:
+    using System = std::function<void(float delta_time)>;
+
+    class Access {
+    public:
+        template<typename... Ts>
+        Access& read() {
+            reads_ |= (bit<Ts>() | ... | 0);
+            return *this;
+        }
+
+        template<typename... Ts>
+        Access& write() {
+            writes_ |= (bit<Ts>() | ... | 0);
+            return *this;
+        }
+
+        [[nodiscard]]
+        bool conflicts_with(const Access& other) const {
+            return (writes_ & (other.reads_ | other.writes_)) != 0 || (reads_ & other.writes_) != 0;
+        }
+
+    private:
+        template<typename T>
+        static std::uint64_t bit() { return std::uint64_t{1} << ecs::component_type<T>(); }
+
+        std::uint64_t reads_{0};
+        std::uint64_t writes_{0};
+    };
+
+    explicit SystemScheduler(JobSystem& jobs) : jobs_(jobs) {}
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    void add(std::string name, const Access& access, System system);
+
+    // Runs every system once with `delta_time` seconds. If systems throw, the
+    // others still run and the first exception is rethrown afterwards. Must not be
+    // called from a job.
+    void run(float delta_time);
+
+    [[nodiscard]]
+    size_t size() const { return systems_.size(); }
+
+    [[nodiscard]]
+    const std::string& name(const size_t index) const { return systems_[index].name; }
+
+    // Duration of the system's last run.
+    [[nodiscard]]
+    double time_us(const size_t index) const { return systems_[index].time_us; }
+
+    // Wall time of the last run(), from start until every system finished.
+    [[nodiscard]]
+    double last_run_us() const { return last_run_us_; }
+
+private:
+    struct Entry {
+        std::string name;
+        Access access;
+        System system;
+        // Systems added later that conflict with this one
+        std::vector<size_t> dependents;
+        size_t dependencies{0};
+        double time_us{0.0};
+    };
+
+    // State of one run(), shared with helper jobs that may start after it returned.
+    struct Run {
+        float delta_time{0.0f};
+        std::mutex mutex;
+        std::condition_variable changed;
+        // Per system, conflicting predecessors that have not finished yet
+        std::vector<size_t> unmet;
+        std::vector<size_t> ready;
+        size_t remaining{0};
+        std::exception_ptr error;
+    };
+
+    // Queues up to `count` jobs that each run ready systems until none are left.
+    void help(const std::shared_ptr<Run>& run, size_t count);
+    // Runs ready systems on this thread until none are left; `lock` holds run->mutex.
+    void drain(const std::shared_ptr<Run>& run, std::unique_lock<std::mutex>& lock);
+
+    JobSystem& jobs_;
+    std::vector<Entry> systems_;
+    double last_run_us_{0.0};
+};
+
+#endif //SYSTEM_SCHEDULER_H
@@ -0,0 +1,176 @@
+#include "TerrainGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Blocks.h"
+#include "Noise.h"
+
+namespace {
+using noise::kLanes;
+
+// Decorrelates the octaves and the cave noise, which share the seed
+constexpr std::uint32_t kOctaveSeedStep = 0x9e3779b9u;
+constexpr std::uint32_t kCaveSeed = 0x5bd1e995u;
+
+// Caves are flattened: the noise varies this much faster vertically
+constexpr float kCaveSquash = 2.0f;
+
+// Grass, sand and snow are this many blocks deep over the stone
+constexpr int kSoilDepth = 4;
+
+float lerp(const float a, const float b, const float t) {
+    return a + t * (b - a);
+}
+}
+
+TerrainGenerator::TerrainGenerator(const Config& config) : config_(config) {
+}
+
+std::shared_ptr<DenseChunk> TerrainGenerator::generate(const ChunkPos& position) const {
+    float heights[N * N];
+    heightmap(position.x, position.z, heights);
+    const float highest = *std::ranges::max_element(heights);
+    const int base_y = position.y * N;
+    if (base_y >= static_cast<int>(std::floor(highest)) && base_y >= config_.sea_level) {
+        return nullptr;
+    }
+    auto chunk = std::make_shared<DenseChunk>();
+    fill(position, heights, *chunk);
+    return chunk;
+}
+
+void TerrainGenerator::heightmap(const int chunk_x, const int chunk_z,
+                                 const std::span<float, kChunkSize * kChunkSize> heights) const {
+    // Sum of the octave amplitudes, which scales the total back to about [-1, 1]
+    float total = 0.0f;
+    for (int octave = 0; octave < config_.octaves; octave++) {
+        total += std::pow(config_.persistence, static_cast<float>(octave));
+    }
+    const float scale = total > 0.0f ? config_.height_amplitude / total : 0.0f;
+
+    float x[kLanes];
+    float z[kLanes];
+    float sample[kLanes];
+    float sum[kLanes];
+    for (int row = 0; row < N; row++) {
+        for (int first = 0; first < N; first += static_cast<int>(kLanes)) {
+            std::ranges::fill(sum, 0.0f);
+            float frequency = 1.0f / config_.hill_scale;
+            float amplitude = 1.0f;
+            for (int octave = 0; octave < config_.octaves; octave++) {
+                // Shifted per octave so the lattices of different octaves do not line up
+                const float offset = 0.31f * static_cast<float>(octave);
+                for (size_t lane = 0; lane < kLanes; lane++) {
+                    x[lane] = static_cast<float>(chunk_x * N + first + static_cast<int>(lane)) * frequency + offset;
+                    z[lane] = static_cast<float>(chunk_z * N + row) * frequency + offset;
+                }
+                noise::gradient2(config_.seed + static_cast<std::uint32_t>(octave) * kOctaveSeedStep, x, z, sample);
+                for (size_t lane = 0; lane < kLanes; lane++) {
+                    sum[lane] += sample[lane] * amplitude;
+                }
+                frequency *= 2.0f;
+                amplitude *= config_.persistence;
+            }
+            for (size_t lane = 0; lane < kLanes; lane++) {
+                heights[static_cast<size_t>(row * N + first) + lane] = config_.base_height + sum[lane] * scale;
+            }
+        }
+    }
+}
+
+void TerrainGenerator::cave_lattice(const ChunkPos& position,
+                                    const std::span<float, kCavePoints * kCavePoints * kCavePoints> lattice) const {
+    const float frequency = 1.0f / config_.cave_scale;
+    const std::uint32_t seed = config_.seed ^ kCaveSeed;
+    float x[kLanes];
+    float y[kLanes];
+    float z[kLanes];
+    float sample[kLanes];
+    for (size_t first = 0; first < lattice.size(); first += kLanes) {
+        for (size_t lane = 0; lane < kLanes; lane++) {
+            // The last batch repeats the final point in its unused lanes
+            const auto i = static_cast<int>(std::min(first + lane, lattice.size() - 1));
+            const int lx = i % kCavePoints;
+            const int lz = i / kCavePoints % kCavePoints;
+            const int ly = i / (kCavePoints * kCavePoints);
+            x[lane] = static_cast<float>(position.x * N + lx * kCaveStep) * frequency;
+            y[lane] = static_cast<float>(position.y * N + ly * kCaveStep) * frequency * kCaveSquash;
+            z[lane] = static_cast<float>(position.z * N + lz * kCaveStep) * frequency;
+        }
+        noise::gradient3(seed, x, y, z, sample);
+        const size_t count = std::min(kLanes, lattice.size() - first);
+        std::copy_n(sample, count, lattice.begin() + static_cast<std::ptrdiff_t>(first));
+    }
+}
+
+void TerrainGenerator::fill(const ChunkPos& position, const std::span<const float, N * N> heights,
+                            DenseChunk& chunk) const {
+    // Per column: the height of the first air block, what covers it, and how deep
+    // caves must start so they never open onto the sea floor
+    int top[N * N];
+    BlockId surface[N * N];
+    BlockId soil[N * N];
+    int cave_depth[N * N];
+    for (size_t i = 0; i < heights.size(); i++) {
+        top[i] = static_cast<int>(std::floor(heights[i]));
+        const bool beach = top[i] <= config_.sea_level + 1;
+        surface[i] = beach ? kSand : top[i] > config_.snow_height ? kSnow : kGrass;
+        soil[i] = beach ? kSand : kDirt;
+        cave_depth[i] = top[i] <= config_.sea_level ? kSoilDepth : 0;
+    }
+
+    // Cave noise interpolated along x once per lattice row, then per block row
+    // across y and z, so the block loops below are plain element-wise arithmetic
+    const bool caves = config_.cave_scale > 0.0f;
+    float along_x[kCavePoints * kCavePoints][N];
+    if (caves) {
+        float lattice[kCavePoints * kCavePoints * kCavePoints];
+        cave_lattice(position, lattice);
+        for (int row = 0; row < kCavePoints * kCavePoints; row++) {
+            const float* points = lattice + row * kCavePoints;
+            for (int x = 0; x < N; x++) {
+                const float t = static_cast<float>(x % kCaveStep) / kCaveStep;
+                along_x[row][x] = lerp(points[x / kCaveStep], points[x / kCaveStep + 1], t);
+            }
+        }
+    }
+
+    float density[N];
+    std::ranges::fill(density, -1.0f);
+    const float threshold = config_.cave_threshold;
+    for (int y = 0; y < N; y++) {
+        const int world_y = position.y * N + y;
+        const int above_surface = world_y < config_.sea_level ? kWater : kAir;
+        const int ly = y / kCaveStep;
+        const float ty = static_cast<float>(y % kCaveStep) / kCaveStep;
+        for (int z = 0; z < N; z++) {
+            if (caves) {
+                const int lz = z / kCaveStep;
+                const float tz = static_cast<float>(z % kCaveStep) / kCaveStep;
+                const float* a = along_x[ly * kCavePoints + lz];
+                const float* b = along_x[ly * kCavePoints + lz + 1];
+                const float* c = along_x[(ly + 1) * kCavePoints + lz];
+                const float* d = along_x[(ly + 1) * kCavePoints + lz + 1];
+                for (int x = 0; x < N; x++) {
+                    density[x] = lerp(lerp(a[x], b[x], tz), lerp(c[x], d[x], tz), ty);
+                }
+            }
+
+            const int column = z * N;
+            const auto row = chunk.row(y, z);
+            // Fixed trip count over independent blocks vectorizes even at -O2, as long
+            // as every operand is loaded unconditionally and the selects stay branch-free
+            for (int x = 0; x < N; x++) {
+                const int depth = top[column + x] - 1 - world_y;
+                const int cover = surface[column + x];
+                const int under = soil[column + x];
+                int block = depth == 0 ? cover : under;
+                block = depth < kSoilDepth ? block : kStone;
+                block = depth < 0 ? above_surface : block;
+                const bool carved = depth >= cave_depth[column + x] && density[x] > threshold;
+                row[x] = static_cast<BlockId>(carved ? kAir : block);
+            }
+        }
+    }
+}
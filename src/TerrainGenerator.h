@@ -0,0 +1,71 @@
+#ifndef TERRAIN_GENERATOR_H
+#define TERRAIN_GENERATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include "Chunk.h"
+
+// Procedural terrain: a multi-octave noise heightmap covered in grass, dirt and
+// stone, with sand beaches and water up to sea level, snow on the peaks, and caves
+// carved out by 3D noise. Every block is a pure function of the seed and its
+// position, so chunks can be generated in any order and on any thread and still
+// line up with their neighbours and with earlier runs.
+//
+// Noise is evaluated in batches of noise::kLanes (see Noise.h). The heightmap is
+// sampled once per column; cave noise only on a lattice every kCaveStep blocks
+// and interpolated in between, which is smooth at cave scale and costs a fraction
+// of sampling every block. Chunks above both the surface and sea level are
+// recognized from the heightmap alone and never allocated.
+//
+// Thread-safe: generate() only reads the configuration.
+class TerrainGenerator {
+public:
+    struct Config {
+        std::uint32_t seed{1};
+        // Average surface height and how far the hills reach from it, in blocks
+        float base_height{48.0f};
+        float height_amplitude{48.0f};
+        // Width of the largest hills, in blocks
+        float hill_scale{256.0f};
+        // Each octave adds detail at twice the frequency and `persistence` times the amplitude
+        int octaves{5};
+        float persistence{0.5f};
+        int sea_level{40};
+        // Surface blocks at or above this are snow
+        int snow_height{68};
+        // Size of cave pockets, in blocks; 0 disables caves
+        float cave_scale{40.0f};
+        // Cave noise above this is carved out; higher means fewer, smaller caves
+        float cave_threshold{0.35f};
+    };
+
+    // Lattice spacing of the cave noise, in blocks.
+    static constexpr int kCaveStep = 4;
+
+    explicit TerrainGenerator(const Config& config);
+
+    // The blocks of chunk `position`, or nullptr if it is entirely air.
+    [[nodiscard]]
+    std::shared_ptr<DenseChunk> generate(const ChunkPos& position) const;
+
+    // Surface height of each column of chunk column (chunk_x, chunk_z), at index
+    // z * kChunkSize + x: blocks below it are solid, apart from caves.
+    void heightmap(int chunk_x, int chunk_z, std::span<float, kChunkSize * kChunkSize> heights) const;
+
+    [[nodiscard]]
+    const Config& config() const { return config_; }
+
+private:
+    static constexpr int N = kChunkSize;
+    static constexpr int kCavePoints = N / kCaveStep + 1;
+
+    // Cave noise on the lattice of chunk `position`, at index (y * kCavePoints + z) * kCavePoints + x.
+    void cave_lattice(const ChunkPos& position, std::span<float, kCavePoints * kCavePoints * kCavePoints> lattice) const;
+    void fill(const ChunkPos& position, std::span<const float, N * N> heights, DenseChunk& chunk) const;
+
+    Config config_;
+};
+
+#endif //TERRAIN_GENERATOR_H
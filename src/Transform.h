@@ -1,13 +1,29 @@
 #ifndef TRANSFORM_H
 #define TRANSFORM_H
+#include <span>
+
 #include "glm/fwd.hpp"
+#include "glm/mat4x4.hpp"
 #include "glm/detail/type_quat.hpp"
 #include "glm/ext/quaternion_trigonometric.hpp"
 
-struct Transform {
-    glm::vec3 position;
-    glm::quat rotation;
-    glm::vec3 scale;
+class Transform;
+
+namespace transforms {
+// Recomputes the model matrix of every dirty transform in the span, several at a
+// time (see TransformBatch.cpp).
+void update_matrices(std::span<Transform> transforms);
+}
+
+// Position, rotation and scale, plus the model matrix they compose to. Setters
+// mark the matrix dirty; it is rebuilt either in bulk by transforms::update_matrices()
+// or on the next matrix() call.
+class Transform {
+public:
+    Transform() = default;
+
+    Transform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) :
+        position_(position), rotation_(rotation), scale_(scale) {}
 
     static Transform of( const glm::vec3& position) {
         return {position, {0.f, 1.f, 0.f, 0.f}, glm::vec3(1.0f)};
@@ -16,6 +32,68 @@ struct Transform {
     static Transform of( const glm::vec3& position, const float scale) {
         return {position, {0.f, 1.f, 0.f, 0.f}, glm::vec3(scale)};
     }
+
+    [[nodiscard]]
+    const glm::vec3& position() const { return position_; }
+
+    [[nodiscard]]
+    const glm::quat& rotation() const { return rotation_; }
+
+    [[nodiscard]]
+    const glm::vec3& scale() const { return scale_; }
+
+    void set_position(const glm::vec3& position) {
+        position_ = position;
+        dirty_ = true;
+    }
+
+    void set_rotation(const glm::quat& rotation) {
+        rotation_ = rotation;
+        dirty_ = true;
+    }
+
+    void set_scale(const glm::vec3& scale) {
+        scale_ = scale;
+        dirty_ = true;
+    }
+
+    [[nodiscard]]
+    bool dirty() const { return dirty_; }
+
+    // Scale, then rotate (the rotation is assumed to be a unit quaternion), then
+    // translate. Rebuilt here if still dirty, which is not safe to do from several
+    // threads at once; batch-update shared transforms first.
+    [[nodiscard]]
+    const glm::mat4& matrix() const {
+        if (dirty_) {
+            matrix_ = compose(position_, rotation_, scale_);
+            dirty_ = false;
+        }
+        return matrix_;
+    }
+
+private:
+    friend void transforms::update_matrices(std::span<Transform> transforms);
+
+    // Same formula as the lanes in TransformBatch.cpp, one transform at a time.
+    static glm::mat4 compose(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        const float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+        return {
+            glm::vec4((1.0f - 2.0f * (y * y + z * z)) * scale.x, 2.0f * (x * y + w * z) * scale.x,
+                      2.0f * (x * z - w * y) * scale.x, 0.0f),
+            glm::vec4(2.0f * (x * y - w * z) * scale.y, (1.0f - 2.0f * (x * x + z * z)) * scale.y,
+                      2.0f * (y * z + w * x) * scale.y, 0.0f),
+            glm::vec4(2.0f * (x * z + w * y) * scale.z, 2.0f * (y * z - w * x) * scale.z,
+                      (1.0f - 2.0f * (x * x + y * y)) * scale.z, 0.0f),
+            glm::vec4(position, 1.0f),
+        };
+    }
+
+    glm::vec3 position_{0.0f};
+    glm::quat rotation_{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale_{1.0f};
+    mutable glm::mat4 matrix_{1.0f};
+    mutable bool dirty_{true};
 };
 
 static glm::quat xAxisRotation(const float deg) {
@@ -30,7 +108,7 @@ static glm::quat zAxisRotation(const float deg) {
     return angleAxis(glm::radians(deg), glm::vec3(0.0f, 0.0f, 1.0f));
 }
 
-static constexpr Transform TRANSFORM_ZERO = {
+inline const Transform TRANSFORM_ZERO = {
     {0, 0, 0},
     {0, 0, 0, 0},
     {0, 0, 0}
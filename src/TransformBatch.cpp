@@ -0,0 +1,84 @@
+#include "Transform.h"
+
+#include <cstddef>
+
+namespace transforms {
+namespace {
+constexpr size_t kLanes = 8;
+
+// Inputs and outputs of kLanes transforms, one array per scalar so the lane loop
+// below is plain element-wise arithmetic.
+struct Block {
+    float px[kLanes], py[kLanes], pz[kLanes];
+    float qx[kLanes], qy[kLanes], qz[kLanes], qw[kLanes];
+    float sx[kLanes], sy[kLanes], sz[kLanes];
+    // Upper 3x3 of the model matrix, column-major
+    float m[9][kLanes];
+};
+
+void compose(Block& block) {
+    // Fixed trip count over independent lanes vectorizes even at -O2
+    for (size_t lane = 0; lane < kLanes; lane++) {
+        const float x = block.qx[lane], y = block.qy[lane], z = block.qz[lane], w = block.qw[lane];
+        const float xx = x * x, yy = y * y, zz = z * z;
+        const float xy = x * y, xz = x * z, yz = y * z;
+        const float wx = w * x, wy = w * y, wz = w * z;
+        const float sx = block.sx[lane], sy = block.sy[lane], sz = block.sz[lane];
+
+        block.m[0][lane] = (1.0f - 2.0f * (yy + zz)) * sx;
+        block.m[1][lane] = 2.0f * (xy + wz) * sx;
+        block.m[2][lane] = 2.0f * (xz - wy) * sx;
+        block.m[3][lane] = 2.0f * (xy - wz) * sy;
+        block.m[4][lane] = (1.0f - 2.0f * (xx + zz)) * sy;
+        block.m[5][lane] = 2.0f * (yz + wx) * sy;
+        block.m[6][lane] = 2.0f * (xz + wy) * sz;
+        block.m[7][lane] = 2.0f * (yz - wx) * sz;
+        block.m[8][lane] = (1.0f - 2.0f * (xx + yy)) * sz;
+    }
+}
+}
+
+void update_matrices(const std::span<Transform> transforms) {
+    Block block{};
+    Transform* pending[kLanes];
+    size_t count = 0;
+
+    const auto flush = [&] {
+        compose(block);
+        for (size_t lane = 0; lane < count; lane++) {
+            Transform& transform = *pending[lane];
+            transform.matrix_[0] = glm::vec4(block.m[0][lane], block.m[1][lane], block.m[2][lane], 0.0f);
+            transform.matrix_[1] = glm::vec4(block.m[3][lane], block.m[4][lane], block.m[5][lane], 0.0f);
+            transform.matrix_[2] = glm::vec4(block.m[6][lane], block.m[7][lane], block.m[8][lane], 0.0f);
+            transform.matrix_[3] = glm::vec4(block.px[lane], block.py[lane], block.pz[lane], 1.0f);
+            transform.dirty_ = false;
+        }
+        count = 0;
+    };
+
+    // Gather dirty transforms into SoA blocks; clean ones cost one flag test.
+    // Lanes past `count` in the last block hold stale inputs whose results are dropped.
+    for (Transform& transform: transforms) {
+        if (!transform.dirty_) {
+            continue;
+        }
+        block.px[count] = transform.position_.x;
+        block.py[count] = transform.position_.y;
+        block.pz[count] = transform.position_.z;
+        block.qx[count] = transform.rotation_.x;
+        block.qy[count] = transform.rotation_.y;
+        block.qz[count] = transform.rotation_.z;
+        block.qw[count] = transform.rotation_.w;
+        block.sx[count] = transform.scale_.x;
+        block.sy[count] = transform.scale_.y;
+        block.sz[count] = transform.scale_.z;
+        pending[count++] = &transform;
+        if (count == kLanes) {
+            flush();
+        }
+    }
+    if (count > 0) {
+        flush();
+    }
+}
+}
@@ -4,8 +4,8 @@
 #include "glm/vec4.hpp"
 
 struct Vertex {
-    const float x, y, z;
-    const float r, g, b, a;
+    float x, y, z;
+    float r, g, b, a;
 
     explicit Vertex(const glm::vec3& v, const glm::vec4& c = {1.0f, 1.0f, 1.0f, 1.0f}) :
     x(v.x), y(v.y), z(v.z),
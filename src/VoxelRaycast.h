@@ -0,0 +1,175 @@
+#ifndef VOXEL_RAYCAST_H
+#define VOXEL_RAYCAST_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+#include "glm/vec3.hpp"
+#include "Blocks.h"
+#include "Chunk.h"
+#include "JobSystem.h"
+
+// Ray traversal over chunk storage (Amanatides & Woo, "A Fast Voxel Traversal
+// Algorithm for Ray Tracing"), for picking and line-of-sight queries.
+//
+// Coordinates are in blocks: block b spans [b, b + 1) and chunk p spans
+// p * kChunkSize to (p + 1) * kChunkSize. The walk is two-level: an outer DDA steps
+// from chunk to chunk and an inner one from block to block, only inside chunks the
+// lookup returns. Missing chunks (not loaded, or all air) are crossed in a single
+// step, so rays through open sky cost one hash lookup per chunk.
+//
+// `lookup(const ChunkPos&)` returns a `const DenseChunk*`, or nullptr for a chunk
+// without blocks. trace_batch() calls it from several threads at once.
+namespace raycast {
+struct Ray {
+    glm::vec3 origin;
+    // Need not be normalized, but must not be zero
+    glm::vec3 direction;
+    float max_distance;
+};
+
+struct Hit {
+    glm::ivec3 block;
+    BlockId id;
+    // Face the ray entered the block through; for a ray starting inside a block,
+    // the face against its main direction
+    Face face;
+    // From the ray's origin, in blocks
+    float distance;
+};
+
+namespace detail {
+// Per-axis DDA state for cells of `cell_size` blocks.
+struct Walk {
+    int cell[3];
+    int step[3];
+    float t_max[3];
+    float t_delta[3];
+
+    Walk(const float origin[3], const float direction[3], const float cell_size, const float t) {
+        for (int a = 0; a < 3; a++) {
+            cell[a] = static_cast<int>(std::floor((origin[a] + direction[a] * t) / cell_size));
+        }
+        reset(origin, direction, cell_size);
+    }
+
+    // Recomputes the crossings after `cell` was set.
+    void reset(const float origin[3], const float direction[3], const float cell_size) {
+        constexpr float kInfinity = std::numeric_limits<float>::infinity();
+        for (int a = 0; a < 3; a++) {
+            if (direction[a] == 0.0f) {
+                step[a] = 0;
+                t_max[a] = kInfinity;
+                t_delta[a] = kInfinity;
+                continue;
+            }
+            step[a] = direction[a] > 0.0f ? 1 : -1;
+            const float boundary = static_cast<float>(cell[a] + (step[a] > 0 ? 1 : 0)) * cell_size;
+            t_max[a] = (boundary - origin[a]) / direction[a];
+            t_delta[a] = cell_size / std::abs(direction[a]);
+        }
+    }
+
+    // Axis of the nearest crossing.
+    [[nodiscard]]
+    int next_axis() const {
+        if (t_max[0] < t_max[1]) {
+            return t_max[0] < t_max[2] ? 0 : 2;
+        }
+        return t_max[1] < t_max[2] ? 1 : 2;
+    }
+
+    void advance(const int axis) {
+        cell[axis] += step[axis];
+        t_max[axis] += t_delta[axis];
+    }
+};
+
+inline Face entry_face(const int axis, const int step) {
+    return static_cast<Face>(axis * 2 + (step > 0 ? 0 : 1));
+}
+}
+
+template<typename ChunkLookup>
+std::optional<Hit> trace(const Ray& ray, const ChunkLookup& lookup) {
+    const float length = std::sqrt(ray.direction.x * ray.direction.x + ray.direction.y * ray.direction.y
+                                   + ray.direction.z * ray.direction.z);
+    if (length == 0.0f) {
+        throw std::runtime_error("Ray direction is zero");
+    }
+    const float origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+    const float direction[3] = {ray.direction.x / length, ray.direction.y / length, ray.direction.z / length};
+
+    // Axis the ray last crossed, and which way; starts as its main direction
+    int axis = 0;
+    for (int a = 1; a < 3; a++) {
+        if (std::abs(direction[a]) > std::abs(direction[axis])) {
+            axis = a;
+        }
+    }
+    detail::Walk chunks(origin, direction, static_cast<float>(kChunkSize), 0.0f);
+    int entry_step = chunks.step[axis];
+
+    for (float t_enter = 0.0f; t_enter <= ray.max_distance;) {
+        const ChunkPos position(chunks.cell[0], chunks.cell[1], chunks.cell[2]);
+        if (const DenseChunk* chunk = lookup(position)) {
+            const int base[3] = {position.x * kChunkSize, position.y * kChunkSize, position.z * kChunkSize};
+            detail::Walk blocks(origin, direction, 1.0f, t_enter);
+            // Rounding can put the entry point just outside the chunk
+            for (int a = 0; a < 3; a++) {
+                blocks.cell[a] = std::clamp(blocks.cell[a], base[a], base[a] + kChunkSize - 1);
+            }
+            blocks.reset(origin, direction, 1.0f);
+
+            float t = t_enter;
+            int block_axis = axis;
+            int block_step = entry_step;
+            while (t <= ray.max_distance) {
+                const int x = blocks.cell[0] - base[0];
+                const int y = blocks.cell[1] - base[1];
+                const int z = blocks.cell[2] - base[2];
+                if (x < 0 || y < 0 || z < 0 || x >= kChunkSize || y >= kChunkSize || z >= kChunkSize) {
+                    break;
+                }
+                if (const BlockId id = chunk->get(x, y, z); id != kAir) {
+                    return Hit{{blocks.cell[0], blocks.cell[1], blocks.cell[2]}, id,
+                               detail::entry_face(block_axis, block_step), t};
+                }
+                block_axis = blocks.next_axis();
+                block_step = blocks.step[block_axis];
+                t = blocks.t_max[block_axis];
+                blocks.advance(block_axis);
+            }
+        }
+        axis = chunks.next_axis();
+        entry_step = chunks.step[axis];
+        t_enter = chunks.t_max[axis];
+        chunks.advance(axis);
+    }
+    return std::nullopt;
+}
+
+// Traces every ray in `rays` into the matching element of `hits`, spread over the
+// calling thread and the JobSystem's workers.
+template<typename ChunkLookup>
+void trace_batch(JobSystem& jobs, const std::span<const Ray> rays, const std::span<std::optional<Hit>> hits,
+                 const ChunkLookup& lookup) {
+    if (hits.size() != rays.size()) {
+        throw std::runtime_error("Ray and hit counts differ");
+    }
+    // Enough rays per task that scheduling is noise next to the tracing
+    constexpr size_t kRaysPerTask = 256;
+    jobs.parallel_for((rays.size() + kRaysPerTask - 1) / kRaysPerTask, [&](const size_t task) {
+        const size_t end = std::min(rays.size(), (task + 1) * kRaysPerTask);
+        for (size_t i = task * kRaysPerTask; i < end; i++) {
+            hits[i] = trace(rays[i], lookup);
+        }
+    });
+}
+}
+
+#endif //VOXEL_RAYCAST_H
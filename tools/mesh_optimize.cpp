@@ -0,0 +1,119 @@
+// Offline mesh optimization: reads a Wavefront OBJ, runs the mesh_optimizer passes
+// and writes the result, reporting the cache statistics before and after.
+//
+//   mesh_optimize <input.obj> [output.obj]
+//
+// Only what the previewer draws survives: positions, optional per-vertex colors
+// ("v x y z r g b") and faces, which are triangulated as fans.
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/MeshOptimizer.h"
+
+namespace {
+struct ObjMesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<Color> colors;
+    std::vector<unsigned int> indices;
+};
+
+// Resolves a face corner ("7", "7/1", "7//3" or a negative relative index).
+unsigned int parse_corner(const std::string& corner, const size_t vertex_count) {
+    const long index = std::stol(corner.substr(0, corner.find('/')));
+    const long resolved = index < 0 ? static_cast<long>(vertex_count) + index : index - 1;
+    if (resolved < 0 || resolved >= static_cast<long>(vertex_count)) {
+        throw std::runtime_error("Face refers to missing vertex " + corner);
+    }
+    return static_cast<unsigned int>(resolved);
+}
+
+ObjMesh read_obj(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+    ObjMesh mesh;
+    bool any_colors = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == "v") {
+            glm::vec3 position;
+            Color color{1.0f, 1.0f, 1.0f, 1.0f};
+            fields >> position.x >> position.y >> position.z;
+            if (fields >> color.r >> color.g >> color.b) {
+                any_colors = true;
+            }
+            mesh.vertices.push_back(position);
+            mesh.colors.push_back(color);
+        } else if (tag == "f") {
+            std::vector<unsigned int> corners;
+            for (std::string corner; fields >> corner;) {
+                corners.push_back(parse_corner(corner, mesh.vertices.size()));
+            }
+            for (size_t i = 2; i < corners.size(); i++) {
+                mesh.indices.insert(mesh.indices.end(), {corners[0], corners[i - 1], corners[i]});
+            }
+        }
+    }
+    if (!any_colors) {
+        mesh.colors.clear();
+    }
+    return mesh;
+}
+
+void write_obj(const std::string& path, const ObjMesh& mesh) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Failed to open " + path + " for writing");
+    }
+    for (size_t v = 0; v < mesh.vertices.size(); v++) {
+        const glm::vec3& p = mesh.vertices[v];
+        out << "v " << p.x << ' ' << p.y << ' ' << p.z;
+        if (!mesh.colors.empty()) {
+            const Color& c = mesh.colors[v];
+            out << ' ' << c.r << ' ' << c.g << ' ' << c.b;
+        }
+        out << '\n';
+    }
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        out << "f " << mesh.indices[i] + 1 << ' ' << mesh.indices[i + 1] + 1 << ' ' << mesh.indices[i + 2] + 1 << '\n';
+    }
+}
+
+void print_stats(const std::string& label, const mesh_optimizer::CacheStats& stats) {
+    std::cout << std::left << std::setw(8) << label << std::fixed << std::setprecision(3)
+              << "ACMR " << stats.acmr << "  ATVR " << stats.atvr << std::endl;
+}
+}
+
+int main(const int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " <input.obj> [output.obj]" << std::endl;
+        return 2;
+    }
+    try {
+        ObjMesh mesh = read_obj(argv[1]);
+        std::cout << mesh.vertices.size() << " vertices, " << mesh.indices.size() / 3 << " triangles" << std::endl;
+
+        const auto report = mesh_optimizer::optimize(mesh.vertices, mesh.indices, mesh.colors);
+        print_stats("before", report.before);
+        print_stats("after", report.after);
+
+        if (argc == 3) {
+            write_obj(argv[2], mesh);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}